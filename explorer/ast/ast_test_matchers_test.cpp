@@ -31,7 +31,10 @@ TEST(BlockContentsAreTest, BasicUsage) {
   Break break_node(DummyLoc);
   EXPECT_THAT(break_node, Not(BlockContentsAre(_)));
 
-  Block break_block(DummyLoc, {&break_node});
+  Arena arena;
+  Block break_block(
+      DummyLoc,
+      arena.NewSpan(llvm::ArrayRef<Nonnull<Statement*>>(&break_node)));
   EXPECT_THAT(break_block, Not(BlockContentsAre(IsEmpty())));
 }
 
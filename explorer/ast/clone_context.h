@@ -13,6 +13,7 @@
 #include "explorer/ast/ast_rtti.h"
 #include "explorer/base/arena.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Casting.h"
 
 namespace Carbon {
@@ -89,6 +90,16 @@ class CloneContext {
     return result;
   }
 
+  template <typename T>
+  auto Clone(const ArenaSpan<T>& nodes) -> ArenaSpan<T> {
+    llvm::SmallVector<T> result;
+    result.reserve(nodes.size());
+    for (const auto& node : nodes) {
+      result.push_back(Clone(node));
+    }
+    return arena_->NewSpan(llvm::ArrayRef<T>(result));
+  }
+
   // Find the new or existing node corresponding to the given node. This should
   // be used when a cloned node has a non-owning reference to another node,
   // that might refer to something being cloned or might refer to the original
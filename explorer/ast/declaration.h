@@ -702,7 +702,7 @@ class ConstraintTypeDeclaration : public Declaration {
         members_(std::move(members)) {
     // `interface X` has `Self:! X`.
     auto* self_type_ref = arena->New<IdentifierExpression>(
-        source_loc, std::string(name_.inner_name()));
+        source_loc, arena->Intern(name_.inner_name()));
     self_type_ref->set_value_node(self_type_);
     self_ = arena->New<GenericBinding>(source_loc, "Self", self_type_ref,
                                        GenericBinding::BindingKind::Checked);
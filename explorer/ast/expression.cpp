@@ -110,7 +110,8 @@ auto ExpressionFromParenContents(
 auto TupleExpressionFromParenContents(
     Nonnull<Arena*> arena, SourceLocation source_loc,
     const ParenContents<Expression>& paren_contents) -> Nonnull<TupleLiteral*> {
-  return arena->New<TupleLiteral>(source_loc, paren_contents.elements);
+  return arena->New<TupleLiteral>(source_loc,
+                                  arena->NewSpan(paren_contents.elements));
 }
 
 Expression::~Expression() = default;
@@ -186,9 +186,11 @@ auto OperatorToString(Operator op) -> std::string_view;
 
 class IdentifierExpression : public Expression {
  public:
-  explicit IdentifierExpression(SourceLocation source_loc, std::string name)
+  // `name` must outlive the node, such as by being interned in the arena.
+  explicit IdentifierExpression(SourceLocation source_loc,
+                                std::string_view name)
       : Expression(AstNodeKind::IdentifierExpression, source_loc),
-        name_(std::move(name)) {}
+        name_(name) {}
 
   explicit IdentifierExpression(CloneContext& context,
                                 const IdentifierExpression& other)
@@ -200,7 +202,7 @@ class IdentifierExpression : public Expression {
     return InheritsFromIdentifierExpression(node->kind());
   }
 
-  auto name() const -> const std::string& { return name_; }
+  auto name() const -> std::string_view { return name_; }
 
   // Returns the ValueNodeView this identifier refers to. Cannot be called
   // before name resolution.
@@ -214,7 +216,7 @@ class IdentifierExpression : public Expression {
   }
 
  private:
-  std::string name_;
+  std::string_view name_;
   std::optional<ValueNodeView> value_node_;
 };
 
@@ -332,12 +334,14 @@ class MemberAccessExpression : public Expression {
 class SimpleMemberAccessExpression
     : public RewritableMixin<MemberAccessExpression> {
  public:
+  // `member_name` must outlive the node, such as by being interned in the
+  // arena.
   explicit SimpleMemberAccessExpression(SourceLocation source_loc,
                                         Nonnull<Expression*> object,
-                                        std::string member_name)
+                                        std::string_view member_name)
       : RewritableMixin(AstNodeKind::SimpleMemberAccessExpression, source_loc,
                         object),
-        member_name_(std::move(member_name)) {}
+        member_name_(member_name) {}
 
   explicit SimpleMemberAccessExpression(
       CloneContext& context, const SimpleMemberAccessExpression& other);
@@ -346,7 +350,7 @@ class SimpleMemberAccessExpression
     return InheritsFromSimpleMemberAccessExpression(node->kind());
   }
 
-  auto member_name() const -> const std::string& { return member_name_; }
+  auto member_name() const -> std::string_view { return member_name_; }
 
   // Returns the `NamedElement` that the member name resolved to.
   // Should not be called before typechecking.
@@ -386,7 +390,7 @@ class SimpleMemberAccessExpression
   }
 
  private:
-  std::string member_name_;
+  std::string_view member_name_;
   std::optional<Nonnull<const NamedElement*>> member_;
   std::optional<Nonnull<const InterfaceType*>> found_in_interface_;
   std::optional<ValueNodeView> value_node_;
@@ -572,9 +576,8 @@ class TupleLiteral : public Expression {
       : TupleLiteral(source_loc, {}) {}
 
   explicit TupleLiteral(SourceLocation source_loc,
-                        std::vector<Nonnull<Expression*>> fields)
-      : Expression(AstNodeKind::TupleLiteral, source_loc),
-        fields_(std::move(fields)) {}
+                        ArenaSpan<Nonnull<Expression*>> fields)
+      : Expression(AstNodeKind::TupleLiteral, source_loc), fields_(fields) {}
 
   explicit TupleLiteral(CloneContext& context, const TupleLiteral& other)
       : Expression(context, other), fields_(context.Clone(other.fields_)) {}
@@ -589,7 +592,7 @@ class TupleLiteral : public Expression {
   auto fields() -> llvm::ArrayRef<Nonnull<Expression*>> { return fields_; }
 
  private:
-  std::vector<Nonnull<Expression*>> fields_;
+  ArenaSpan<Nonnull<Expression*>> fields_;
 };
 
 // A literal value of a struct type.
@@ -725,7 +728,8 @@ class CallExpression : public Expression {
       : Expression(context, other),
         function_(context.Clone(other.function_)),
         argument_(context.Clone(other.argument_)),
-        bindings_(context.Clone(other.bindings_)) {}
+        bindings_(context.Clone(other.bindings_)),
+        is_tail_call_(other.is_tail_call_) {}
 
   static auto classof(const AstNode* node) -> bool {
     return InheritsFromCallExpression(node->kind());
@@ -756,10 +760,20 @@ class CallExpression : public Expression {
   // Can only be called by type-checking, if a conversion was required.
   void set_argument(Nonnull<Expression*> argument) { argument_ = argument; }
 
+  // Whether this call is in tail position: it is the operand of a `return`
+  // statement, and its result is returned without conversion. A tail call can
+  // reuse the frame of the function it returns from.
+  auto is_tail_call() const -> bool { return is_tail_call_; }
+
+  // Set by ResolveControlFlow, and cleared by type-checking if the result
+  // requires a conversion.
+  void set_is_tail_call(bool is_tail_call) { is_tail_call_ = is_tail_call; }
+
  private:
   Nonnull<Expression*> function_;
   Nonnull<Expression*> argument_;
   Bindings bindings_;
+  bool is_tail_call_ = false;
 };
 
 class FunctionTypeLiteral : public ConstantValueLiteral {
@@ -852,6 +866,14 @@ class ValueLiteral : public ConstantValueLiteral {
   }
 };
 
+// A piece of a `Print` format string: literal text, followed by an argument
+// if `arg_index` is set.
+struct PrintFormatSegment {
+  // The text to print, with `{{` escapes already replaced by `{`.
+  std::string text;
+  std::optional<int> arg_index;
+};
+
 class IntrinsicExpression : public RewritableMixin<Expression> {
  public:
   enum class Intrinsic {
@@ -901,9 +923,23 @@ class IntrinsicExpression : public RewritableMixin<Expression> {
   auto args() const -> const TupleLiteral& { return *args_; }
   auto args() -> TupleLiteral& { return *args_; }
 
+  // The segments of the format string of a `Print` whose format string is a
+  // literal, which is validated and split up once, during type-checking. Other
+  // format strings are handled each time the `Print` runs. This isn't
+  // cloned, because a clone is type-checked again.
+  auto print_format() const
+      -> std::optional<llvm::ArrayRef<PrintFormatSegment>> {
+    return print_format_;
+  }
+  void set_print_format(std::vector<PrintFormatSegment> print_format) {
+    CARBON_CHECK(!print_format_) << "print format set twice";
+    print_format_ = std::move(print_format);
+  }
+
  private:
   Intrinsic intrinsic_;
   Nonnull<TupleLiteral*> args_;
+  std::optional<std::vector<PrintFormatSegment>> print_format_;
 };
 
 class IfExpression : public Expression {
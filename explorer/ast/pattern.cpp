@@ -155,7 +155,8 @@ auto TuplePatternFromParenContents(Nonnull<Arena*> arena,
                                    SourceLocation source_loc,
                                    const ParenContents<Pattern>& paren_contents)
     -> Nonnull<TuplePattern*> {
-  return arena->New<TuplePattern>(source_loc, paren_contents.elements);
+  return arena->New<TuplePattern>(source_loc,
+                                  arena->NewSpan(paren_contents.elements));
 }
 
 // Used by AlternativePattern for constructor initialization. Produces a helpful
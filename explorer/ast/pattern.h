@@ -17,6 +17,7 @@
 #include "explorer/ast/expression.h"
 #include "explorer/ast/expression_category.h"
 #include "explorer/ast/value_node.h"
+#include "explorer/base/arena.h"
 #include "explorer/base/source_location.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
@@ -167,11 +168,12 @@ class BindingPattern : public Pattern {
  public:
   using ImplementsCarbonValueNode = void;
 
-  BindingPattern(SourceLocation source_loc, std::string name,
+  // `name` must outlive the pattern, such as by being interned in the arena.
+  BindingPattern(SourceLocation source_loc, std::string_view name,
                  Nonnull<Pattern*> type,
                  std::optional<ExpressionCategory> expression_category)
       : Pattern(AstNodeKind::BindingPattern, source_loc),
-        name_(std::move(name)),
+        name_(name),
         type_(type),
         expression_category_(expression_category) {}
 
@@ -188,7 +190,7 @@ class BindingPattern : public Pattern {
   // The name this pattern binds, if any. If equal to AnonymousName, indicates
   // that this BindingPattern does not bind a name, which in turn means it
   // should not be used as a ValueNode.
-  auto name() const -> const std::string& { return name_; }
+  auto name() const -> std::string_view { return name_; }
 
   // The pattern specifying the type of values that this pattern matches.
   auto type() const -> const Pattern& { return *type_; }
@@ -221,7 +223,7 @@ class BindingPattern : public Pattern {
   }
 
  private:
-  std::string name_;
+  std::string_view name_;
   Nonnull<Pattern*> type_;
   std::optional<ExpressionCategory> expression_category_;
 };
@@ -249,9 +251,8 @@ class AddrPattern : public Pattern {
 // A pattern that matches a tuple value field-wise.
 class TuplePattern : public Pattern {
  public:
-  TuplePattern(SourceLocation source_loc, std::vector<Nonnull<Pattern*>> fields)
-      : Pattern(AstNodeKind::TuplePattern, source_loc),
-        fields_(std::move(fields)) {}
+  TuplePattern(SourceLocation source_loc, ArenaSpan<Nonnull<Pattern*>> fields)
+      : Pattern(AstNodeKind::TuplePattern, source_loc), fields_(fields) {}
 
   explicit TuplePattern(CloneContext& context, const TuplePattern& other)
       : Pattern(context, other), fields_(context.Clone(other.fields_)) {}
@@ -266,7 +267,7 @@ class TuplePattern : public Pattern {
   auto fields() -> llvm::ArrayRef<Nonnull<Pattern*>> { return fields_; }
 
  private:
-  std::vector<Nonnull<Pattern*>> fields_;
+  ArenaSpan<Nonnull<Pattern*>> fields_;
 };
 
 class GenericBinding : public Pattern {
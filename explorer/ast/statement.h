@@ -54,9 +54,8 @@ class Statement : public AstNode {
 
 class Block : public Statement {
  public:
-  Block(SourceLocation source_loc, std::vector<Nonnull<Statement*>> statements)
-      : Statement(AstNodeKind::Block, source_loc),
-        statements_(std::move(statements)) {}
+  Block(SourceLocation source_loc, ArenaSpan<Nonnull<Statement*>> statements)
+      : Statement(AstNodeKind::Block, source_loc), statements_(statements) {}
 
   explicit Block(CloneContext& context, const Block& other)
       : Statement(context, other),
@@ -74,7 +73,7 @@ class Block : public Statement {
   }
 
  private:
-  std::vector<Nonnull<Statement*>> statements_;
+  ArenaSpan<Nonnull<Statement*>> statements_;
 };
 
 class ExpressionStatement : public Statement {
@@ -163,11 +163,25 @@ static auto GetPositionalElement(Nonnull<const TupleValue*> tuple,
       << "Invalid non-tuple member";
   const auto* tuple_element = cast<PositionalElement>(path_comp.element());
   const size_t index = tuple_element->index();
-  if (index < 0 || index >= tuple->elements().size()) {
+  if (index < 0 || index >= tuple->num_elements()) {
     return ProgramError(source_loc)
            << "index " << index << " out of range for " << *tuple;
   }
-  return tuple->elements()[index];
+  return tuple->element(index);
+}
+
+auto MakeImplMemberValue(Nonnull<Arena*> arena,
+                         Nonnull<const FunctionDeclaration*> function,
+                         Nonnull<const Bindings*> bindings,
+                         std::optional<Nonnull<const Value*>> me_value)
+    -> Nonnull<const Value*> {
+  if (function->is_method()) {
+    return arena->New<BoundMethodValue>(function, *me_value, bindings);
+  } else {
+    // Class function.
+    const auto* fun = cast<FunctionValue>(*function->constant_value());
+    return arena->New<FunctionValue>(&fun->declaration(), bindings);
+  }
 }
 
 static auto GetNamedElement(Nonnull<Arena*> arena, Nonnull<const Value*> v,
@@ -197,16 +211,9 @@ static auto GetNamedElement(Nonnull<Arena*> arena, Nonnull<const Value*> v,
       if (std::optional<Nonnull<const Declaration*>> mem_decl =
               FindMember(f, impl_witness->declaration().members());
           mem_decl.has_value()) {
-        const auto& fun_decl = cast<FunctionDeclaration>(**mem_decl);
-        if (fun_decl.is_method()) {
-          return arena->New<BoundMethodValue>(&fun_decl, *me_value,
-                                              &impl_witness->bindings());
-        } else {
-          // Class function.
-          const auto* fun = cast<FunctionValue>(*fun_decl.constant_value());
-          return arena->New<FunctionValue>(&fun->declaration(),
-                                           &impl_witness->bindings());
-        }
+        return MakeImplMemberValue(
+            arena, &cast<FunctionDeclaration>(**mem_decl),
+            &impl_witness->bindings(), me_value);
       } else {
         return ProgramError(source_loc)
                << "member " << f << " not in " << *witness;
@@ -407,21 +414,24 @@ static auto SetFieldImpl(
       CARBON_CHECK((*path_begin).element()->kind() ==
                    ElementKind::PositionalElement)
           << "Invalid non-positional member for tuple";
-      std::vector<Nonnull<const Value*>> elements =
-          cast<TupleValueBase>(*value).elements();
+      const auto& tuple = cast<TupleValueBase>(*value);
       const size_t index =
           cast<PositionalElement>((*path_begin).element())->index();
-      if (index < 0 || index >= elements.size()) {
+      if (index < 0 || index >= tuple.num_elements()) {
         return ProgramError(source_loc)
                << "index " << index << " out of range in " << *value;
       }
       CARBON_ASSIGN_OR_RETURN(
-          elements[index], SetFieldImpl(arena, elements[index], path_begin + 1,
-                                        path_end, field_value, source_loc));
+          Nonnull<const Value*> element,
+          SetFieldImpl(arena, tuple.element(index), path_begin + 1, path_end,
+                       field_value, source_loc));
+      // Only the path to the element is copied; the rest is shared.
+      TupleValueBase::Elements elements =
+          tuple.persistent_elements().Set(index, element);
       if (isa<TupleType>(value)) {
-        return arena->New<TupleType>(elements);
+        return arena->New<TupleType>(std::move(elements));
       } else {
-        return arena->New<TupleValue>(elements);
+        return arena->New<TupleValue>(std::move(elements));
       }
     }
     default:
@@ -19,6 +19,7 @@
 #include "explorer/ast/expression_category.h"
 #include "explorer/ast/statement.h"
 #include "explorer/base/nonnull.h"
+#include "explorer/base/persistent_vector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Compiler.h"
 
@@ -512,16 +513,42 @@ class AlternativeValue : public Value {
 // Base class for tuple types and tuple values. These are the same other than
 // their type-of-type, but we separate them to make it easier to tell types and
 // values apart.
+// The elements are held in a persistent vector, so that replacing one element
+// of a large tuple or array, as in `a[i] = x;`, doesn't copy the others. Small
+// tuples hold their elements inline, with no separate allocation.
 class TupleValueBase : public Value {
  public:
+  using Elements = PersistentVector<Nonnull<const Value*>>;
+
   explicit TupleValueBase(Value::Kind kind,
-                          std::vector<Nonnull<const Value*>> elements)
+                          const std::vector<Nonnull<const Value*>>& elements)
+      : Value(kind), elements_(elements) {}
+
+  explicit TupleValueBase(Value::Kind kind, Elements elements)
       : Value(kind), elements_(std::move(elements)) {}
 
+  // Returns the elements as an array. For tuples with more than
+  // `Elements::BranchFactor` elements, the first call copies them into
+  // contiguous storage; prefer `num_elements` and `element` for those.
   auto elements() const -> llvm::ArrayRef<Nonnull<const Value*>> {
-    return elements_;
+    if (auto contiguous = elements_.contiguous()) {
+      return *contiguous;
+    }
+    if (flattened_elements_.empty()) {
+      elements_.AppendTo(flattened_elements_);
+    }
+    return flattened_elements_;
+  }
+
+  auto num_elements() const -> size_t { return elements_.size(); }
+  auto element(size_t index) const -> Nonnull<const Value*> {
+    return elements_[index];
   }
 
+  // Returns the persistent vector of elements, for building a tuple that
+  // shares them.
+  auto persistent_elements() const -> const Elements& { return elements_; }
+
   static auto classof(const Value* value) -> bool {
     return value->kind() == Kind::TupleValue ||
            value->kind() == Kind::TupleType;
@@ -529,11 +556,14 @@ class TupleValueBase : public Value {
 
   template <typename F>
   auto Decompose(F f) const {
-    return f(elements_);
+    return f(std::vector<Nonnull<const Value*>>(elements()));
   }
 
  private:
-  std::vector<Nonnull<const Value*>> elements_;
+  Elements elements_;
+  // A contiguous copy of `elements_`, if it's been needed and isn't already
+  // contiguous.
+  mutable std::vector<Nonnull<const Value*>> flattened_elements_;
 };
 
 // A tuple value.
@@ -546,7 +576,10 @@ class TupleValue : public TupleValueBase {
     return static_cast<Nonnull<const TupleValue*>>(&empty);
   }
 
-  explicit TupleValue(std::vector<Nonnull<const Value*>> elements)
+  explicit TupleValue(const std::vector<Nonnull<const Value*>>& elements)
+      : TupleValueBase(Kind::TupleValue, elements) {}
+
+  explicit TupleValue(Elements elements)
       : TupleValueBase(Kind::TupleValue, std::move(elements)) {}
 
   static auto classof(const Value* value) -> bool {
@@ -565,7 +598,10 @@ class TupleType : public TupleValueBase {
     return static_cast<Nonnull<const TupleType*>>(&empty);
   }
 
-  explicit TupleType(std::vector<Nonnull<const Value*>> elements)
+  explicit TupleType(const std::vector<Nonnull<const Value*>>& elements)
+      : TupleValueBase(Kind::TupleType, elements) {}
+
+  explicit TupleType(Elements elements)
       : TupleValueBase(Kind::TupleType, std::move(elements)) {}
 
   static auto classof(const Value* value) -> bool {
@@ -1279,6 +1315,14 @@ class ImplWitness : public Witness {
   Nonnull<const Bindings*> bindings_ = Bindings::None();
 };
 
+// Returns the value of `function`, a member of an impl with arguments
+// `bindings`. If `function` is a method, it's bound to `me_value`.
+auto MakeImplMemberValue(Nonnull<Arena*> arena,
+                         Nonnull<const FunctionDeclaration*> function,
+                         Nonnull<const Bindings*> bindings,
+                         std::optional<Nonnull<const Value*>> me_value)
+    -> Nonnull<const Value*>;
+
 // The symbolic witness corresponding to an unresolved impl binding.
 class BindingWitness : public Witness {
  public:
@@ -5,16 +5,21 @@
 #ifndef CARBON_EXPLORER_BASE_ARENA_H_
 #define CARBON_EXPLORER_BASE_ARENA_H_
 
+#include <algorithm>
 #include <any>
 #include <map>
 #include <memory>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "explorer/base/nonnull.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/Allocator.h"
 
 namespace Carbon {
 
@@ -33,6 +38,24 @@ struct ArgKey {
 template <typename T>
 using ArgKeyType = typename ArgKey<T>::type;
 
+class Arena;
+
+// A list of elements stored contiguously in an `Arena`, as returned by
+// `Arena::NewSpan`. This is used for the children of AST nodes, so that a node
+// doesn't need a heap allocation of its own for each list.
+template <typename T>
+class ArenaSpan : public llvm::MutableArrayRef<T> {
+ public:
+  // Constructs an empty span.
+  ArenaSpan() = default;
+
+ private:
+  friend class Arena;
+
+  explicit ArenaSpan(llvm::MutableArrayRef<T> elements)
+      : llvm::MutableArrayRef<T>(elements) {}
+};
+
 // Allocates and maintains ownership of arbitrary objects, so that their
 // lifetimes all end at the same time. It can also canonicalize the allocated
 // objects (see the documentation of New).
@@ -94,6 +117,25 @@ class Arena {
       typename std::enable_if_t<std::is_constructible_v<T, Args...>>* = nullptr>
   void New(WriteAddressTo<U> addr, Args&&... args);
 
+  // Returns a copy of `elements` stored contiguously in the arena. Elements are
+  // never destroyed, so they must be trivially destructible.
+  template <typename T>
+  auto NewSpan(llvm::ArrayRef<T> elements) -> ArenaSpan<T>;
+  template <typename T>
+  auto NewSpan(const std::vector<T>& elements) -> ArenaSpan<T> {
+    return NewSpan(llvm::ArrayRef<T>(elements));
+  }
+
+  // Returns a copy of `str` owned by the arena. Each distinct string is stored
+  // once, so interning a name again returns the same storage.
+  auto Intern(std::string_view str) -> std::string_view {
+    auto [it, inserted] = interned_strings_.insert(str);
+    if (inserted) {
+      allocated_ += str.size();
+    }
+    return it->getKey();
+  }
+
   auto allocated() -> int64_t { return allocated_; }
 
  private:
@@ -147,6 +189,12 @@ class Arena {
 
   // Manages allocations in an arena for destruction at shutdown.
   std::vector<std::unique_ptr<ArenaEntry>> arena_;
+
+  // Storage for the elements of spans, which don't need destroying.
+  llvm::BumpPtrAllocator span_allocator_;
+
+  // Strings returned by `Intern`.
+  llvm::StringSet<> interned_strings_;
   int64_t allocated_ = 0;
 
   // Maps a CanonicalizationTable type to a unique instance of that type for
@@ -227,6 +275,19 @@ auto Arena::UniqueNew(Args&&... args) -> Nonnull<T*> {
   return ptr;
 }
 
+template <typename T>
+auto Arena::NewSpan(llvm::ArrayRef<T> elements) -> ArenaSpan<T> {
+  static_assert(std::is_trivially_destructible_v<T>,
+                "Span elements are never destroyed");
+  if (elements.empty()) {
+    return ArenaSpan<T>();
+  }
+  T* storage = span_allocator_.Allocate<T>(elements.size());
+  std::uninitialized_copy(elements.begin(), elements.end(), storage);
+  allocated_ += sizeof(T) * elements.size();
+  return ArenaSpan<T>(llvm::MutableArrayRef<T>(storage, elements.size()));
+}
+
 template <typename T, typename>
 struct Arena::CanonicalizeAllocation : public std::false_type {};
 
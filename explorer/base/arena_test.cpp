@@ -7,6 +7,7 @@
 #include <gtest/gtest.h>
 
 #include <optional>
+#include <string>
 #include <vector>
 
 namespace Carbon {
@@ -93,4 +94,28 @@ TEST(ArenaTest, CanonicalizeStdTypes) {
   EXPECT_TRUE(dummy1 != dummy3);
 }
 
+TEST(ArenaTest, NewSpan) {
+  Arena arena;
+  int i1 = 1;
+  int i2 = 2;
+  std::vector<int*> elements = {&i1, &i2};
+  ArenaSpan<int*> span = arena.NewSpan(elements);
+  elements.clear();
+  ASSERT_EQ(span.size(), 2);
+  EXPECT_EQ(span[0], &i1);
+  EXPECT_EQ(span[1], &i2);
+  EXPECT_TRUE(arena.NewSpan(elements).empty());
+}
+
+TEST(ArenaTest, Intern) {
+  Arena arena;
+  std::string name = "name";
+  std::string_view interned1 = arena.Intern(name);
+  name = "other";
+  std::string_view interned2 = arena.Intern("name");
+  EXPECT_EQ(interned1, "name");
+  EXPECT_EQ(interned1.data(), interned2.data());
+  EXPECT_NE(arena.Intern(name).data(), interned1.data());
+}
+
 }  // namespace Carbon
@@ -0,0 +1,83 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CARBON_EXPLORER_BASE_BUFFERED_OUTPUT_STREAM_H_
+#define CARBON_EXPLORER_BASE_BUFFERED_OUTPUT_STREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "common/check.h"
+#include "explorer/base/nonnull.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace Carbon {
+
+// A stream that collects output in a buffer, and writes it to a sink in
+// batches. The buffer is written out when it's full, when `flush` is called,
+// and when the stream is destroyed. Whoever writes to the sink by other means,
+// such as to report an error, should call `flush` first so that output stays in
+// order.
+class BufferedOutputStream : public llvm::raw_ostream {
+ public:
+  static constexpr size_t DefaultBufferSize = 64 * 1024;
+
+  // Constructs a stream that writes to `sink` once `buffer_size` bytes have
+  // been collected. With a `buffer_size` of 0, each write goes straight to
+  // `sink`, which is useful when other output to the same sink is interleaved.
+  explicit BufferedOutputStream(Nonnull<llvm::raw_ostream*> sink,
+                                size_t buffer_size = DefaultBufferSize)
+      : sink_(sink) {
+    if (buffer_size == 0) {
+      SetUnbuffered();
+    } else {
+      SetBufferSize(buffer_size);
+    }
+  }
+
+  // Constructs a stream that keeps its output in memory, for tests.
+  BufferedOutputStream() : contents_(std::string()) { SetUnbuffered(); }
+
+  ~BufferedOutputStream() override { flush(); }
+
+  // Returns the number of bytes written to the stream, including any that are
+  // still buffered.
+  auto bytes_written() const -> uint64_t { return tell(); }
+
+  // Returns the output of a stream that keeps its output in memory.
+  auto contents() -> llvm::StringRef {
+    CARBON_CHECK(contents_.has_value()) << "Stream has a sink";
+    flush();
+    return *contents_;
+  }
+
+ private:
+  void write_impl(const char* ptr, size_t size) override {
+    bytes_flushed_ += size;
+    if (contents_) {
+      contents_->append(ptr, size);
+      return;
+    }
+    (*sink_)->write(ptr, size);
+    // Make each batch visible as it's written, rather than leaving it in the
+    // sink's own buffer.
+    if (GetBufferSize() != 0) {
+      (*sink_)->flush();
+    }
+  }
+
+  auto current_pos() const -> uint64_t override { return bytes_flushed_; }
+
+  // Exactly one of `sink_` and `contents_` is set.
+  std::optional<Nonnull<llvm::raw_ostream*>> sink_;
+  std::optional<std::string> contents_;
+  uint64_t bytes_flushed_ = 0;
+};
+
+}  // namespace Carbon
+
+#endif  // CARBON_EXPLORER_BASE_BUFFERED_OUTPUT_STREAM_H_
@@ -0,0 +1,56 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "explorer/base/buffered_output_stream.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace Carbon {
+namespace {
+
+TEST(BufferedOutputStreamTest, InMemory) {
+  BufferedOutputStream out;
+  out << "a" << 1 << "\n";
+  EXPECT_EQ(out.contents(), "a1\n");
+  EXPECT_EQ(out.bytes_written(), 3);
+}
+
+TEST(BufferedOutputStreamTest, WritesWhenFull) {
+  std::string sink_contents;
+  llvm::raw_string_ostream sink(sink_contents);
+  BufferedOutputStream out(&sink, /*buffer_size=*/4);
+  out << "ab";
+  EXPECT_EQ(sink_contents, "");
+  EXPECT_EQ(out.bytes_written(), 2);
+  out << "cdef";
+  EXPECT_EQ(sink_contents, "abcd");
+  EXPECT_EQ(out.bytes_written(), 6);
+  out.flush();
+  EXPECT_EQ(sink_contents, "abcdef");
+}
+
+TEST(BufferedOutputStreamTest, FlushesOnDestruction) {
+  std::string sink_contents;
+  llvm::raw_string_ostream sink(sink_contents);
+  {
+    BufferedOutputStream out(&sink);
+    out << "abc";
+    EXPECT_EQ(sink_contents, "");
+  }
+  EXPECT_EQ(sink_contents, "abc");
+}
+
+TEST(BufferedOutputStreamTest, Unbuffered) {
+  std::string sink_contents;
+  llvm::raw_string_ostream sink(sink_contents);
+  BufferedOutputStream out(&sink, /*buffer_size=*/0);
+  out << "abc";
+  EXPECT_EQ(sink_contents, "abc");
+}
+
+}  // namespace
+}  // namespace Carbon
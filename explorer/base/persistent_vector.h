@@ -0,0 +1,213 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CARBON_EXPLORER_BASE_PERSISTENT_VECTOR_H_
+#define CARBON_EXPLORER_BASE_PERSISTENT_VECTOR_H_
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace Carbon {
+
+// An immutable vector whose updates share storage with the original.
+//
+// Vectors of up to `InlineCapacity` elements, which are the common case for
+// tuples, hold their elements inline. Building, copying, reading and `Set` are
+// then a flat copy or access, with no allocation.
+//
+// Larger vectors store their elements in the leaves of a tree in which each
+// node has up to `BranchFactor` children. Reading an element walks from the
+// root to its leaf, and `Set` copies only the nodes on that path, so both take
+// O(log n) time. Copying such a vector is O(1), because copies share all of
+// their nodes.
+template <typename T>
+class PersistentVector {
+ public:
+  static constexpr size_t InlineCapacity = 8;
+  static constexpr int BitsPerLevel = 5;
+  static constexpr size_t BranchFactor = size_t{1} << BitsPerLevel;
+
+  // Constructs an empty vector.
+  PersistentVector() = default;
+
+  // Constructs a vector holding a copy of `elements`.
+  explicit PersistentVector(llvm::ArrayRef<T> elements);
+
+  auto size() const -> size_t { return size_; }
+  auto empty() const -> bool { return size_ == 0; }
+
+  // Returns the element at `index`, which must be less than `size()`.
+  auto operator[](size_t index) const -> const T&;
+
+  // Returns a copy of this vector with the element at `index` replaced by
+  // `value`. This vector is unchanged.
+  auto Set(size_t index, T value) const -> PersistentVector;
+
+  // Returns the elements if they're stored contiguously, which is the case for
+  // vectors of up to `BranchFactor` elements. The array is only valid while
+  // this vector is, because small vectors hold their elements inline.
+  auto contiguous() const -> std::optional<llvm::ArrayRef<T>>;
+
+  // Appends the elements, in order, to `out`.
+  void AppendTo(std::vector<T>& out) const;
+
+  // Vectors held inline compare equal if their elements do. Larger vectors
+  // compare equal only if they share the same storage, so that comparing and
+  // hashing take O(1) time; those with equal elements that were built
+  // separately compare unequal.
+  friend auto operator==(const PersistentVector& lhs,
+                         const PersistentVector& rhs) -> bool {
+    return lhs.root_ == rhs.root_ && lhs.size_ == rhs.size_ &&
+           lhs.inline_elements_ == rhs.inline_elements_;
+  }
+  friend auto hash_value(const PersistentVector& v) -> llvm::hash_code {
+    if (!v.root_) {
+      return llvm::hash_combine_range(v.inline_elements_.begin(),
+                                      v.inline_elements_.end());
+    }
+    return llvm::hash_combine(v.root_.get(), v.size_);
+  }
+
+ private:
+  // A node holds `elements` if it's a leaf, and `children` otherwise.
+  struct Node {
+    std::vector<T> elements;
+    std::vector<std::shared_ptr<const Node>> children;
+  };
+
+  static constexpr size_t IndexMask = BranchFactor - 1;
+
+  // Returns a copy of `node`, which is at `shift`, with the element at `index`
+  // replaced by `value`.
+  static auto SetInNode(const Node& node, int shift, size_t index, T value)
+      -> std::shared_ptr<const Node>;
+
+  // Appends the elements under `node`, which is at `shift`, to `out`.
+  static void AppendNode(const Node& node, int shift, std::vector<T>& out);
+
+  // The elements, if there are at most `InlineCapacity` of them.
+  llvm::SmallVector<T, InlineCapacity> inline_elements_;
+  // Null if the elements are held inline.
+  std::shared_ptr<const Node> root_;
+  // The number of index bits below the root; 0 if the root is a leaf.
+  int shift_ = 0;
+  size_t size_ = 0;
+};
+
+// ---------------------------------------
+// Implementation details only below here.
+// ---------------------------------------
+
+template <typename T>
+PersistentVector<T>::PersistentVector(llvm::ArrayRef<T> elements)
+    : size_(elements.size()) {
+  if (elements.size() <= InlineCapacity) {
+    inline_elements_.assign(elements.begin(), elements.end());
+    return;
+  }
+  // Build the leaves, then each level of parents until there's a single root.
+  std::vector<std::shared_ptr<const Node>> level;
+  for (size_t i = 0; i < elements.size(); i += BranchFactor) {
+    auto leaf = std::make_shared<Node>();
+    leaf->elements.assign(
+        elements.begin() + i,
+        elements.begin() + std::min(i + BranchFactor, elements.size()));
+    level.push_back(std::move(leaf));
+  }
+  while (level.size() > 1) {
+    std::vector<std::shared_ptr<const Node>> parents;
+    for (size_t i = 0; i < level.size(); i += BranchFactor) {
+      auto parent = std::make_shared<Node>();
+      parent->children.assign(
+          level.begin() + i,
+          level.begin() + std::min(i + BranchFactor, level.size()));
+      parents.push_back(std::move(parent));
+    }
+    level = std::move(parents);
+    shift_ += BitsPerLevel;
+  }
+  root_ = std::move(level.front());
+}
+
+template <typename T>
+auto PersistentVector<T>::operator[](size_t index) const -> const T& {
+  if (!root_) {
+    return inline_elements_[index];
+  }
+  const Node* node = root_.get();
+  for (int shift = shift_; shift > 0; shift -= BitsPerLevel) {
+    node = node->children[(index >> shift) & IndexMask].get();
+  }
+  return node->elements[index & IndexMask];
+}
+
+template <typename T>
+auto PersistentVector<T>::Set(size_t index, T value) const
+    -> PersistentVector {
+  PersistentVector result = *this;
+  if (!root_) {
+    result.inline_elements_[index] = std::move(value);
+  } else {
+    result.root_ = SetInNode(*root_, shift_, index, std::move(value));
+  }
+  return result;
+}
+
+template <typename T>
+auto PersistentVector<T>::SetInNode(const Node& node, int shift, size_t index,
+                                    T value) -> std::shared_ptr<const Node> {
+  auto copy = std::make_shared<Node>(node);
+  if (shift == 0) {
+    copy->elements[index & IndexMask] = std::move(value);
+  } else {
+    std::shared_ptr<const Node>& child =
+        copy->children[(index >> shift) & IndexMask];
+    child = SetInNode(*child, shift - BitsPerLevel, index, std::move(value));
+  }
+  return copy;
+}
+
+template <typename T>
+auto PersistentVector<T>::contiguous() const
+    -> std::optional<llvm::ArrayRef<T>> {
+  if (!root_) {
+    return llvm::ArrayRef<T>(inline_elements_);
+  }
+  if (shift_ != 0) {
+    return std::nullopt;
+  }
+  return llvm::ArrayRef<T>(root_->elements);
+}
+
+template <typename T>
+void PersistentVector<T>::AppendTo(std::vector<T>& out) const {
+  if (!root_) {
+    out.insert(out.end(), inline_elements_.begin(), inline_elements_.end());
+    return;
+  }
+  out.reserve(out.size() + size_);
+  AppendNode(*root_, shift_, out);
+}
+
+template <typename T>
+void PersistentVector<T>::AppendNode(const Node& node, int shift,
+                                     std::vector<T>& out) {
+  if (shift == 0) {
+    out.insert(out.end(), node.elements.begin(), node.elements.end());
+    return;
+  }
+  for (const auto& child : node.children) {
+    AppendNode(*child, shift - BitsPerLevel, out);
+  }
+}
+
+}  // namespace Carbon
+
+#endif  // CARBON_EXPLORER_BASE_PERSISTENT_VECTOR_H_
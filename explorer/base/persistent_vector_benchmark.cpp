@@ -0,0 +1,64 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "explorer/base/persistent_vector.h"
+
+namespace Carbon {
+namespace {
+
+// Tuples hold pointers to values, so the benchmarks use pointer elements.
+using Vector = PersistentVector<const int*>;
+
+// Returns `size` distinct pointers to use as elements.
+auto MakeElements(int size) -> std::vector<const int*> {
+  static const std::vector<int> storage(1 << 16);
+  std::vector<const int*> elements;
+  for (int i = 0; i < size; ++i) {
+    elements.push_back(&storage[i]);
+  }
+  return elements;
+}
+
+// Measures building a vector, as each evaluation of a tuple literal does.
+void BM_Construct(benchmark::State& state) {
+  std::vector<const int*> elements = MakeElements(state.range(0));
+  for (auto _ : state) {
+    Vector v(elements);
+    benchmark::DoNotOptimize(v);
+  }
+}
+BENCHMARK(BM_Construct)->Arg(2)->Arg(4)->Arg(8)->Arg(32)->Arg(1024);
+
+// Measures reading every element by index.
+void BM_ReadAll(benchmark::State& state) {
+  Vector v(MakeElements(state.range(0)));
+  for (auto _ : state) {
+    for (size_t i = 0; i < v.size(); ++i) {
+      benchmark::DoNotOptimize(v[i]);
+    }
+  }
+  state.counters["elements_per_second"] = benchmark::Counter(
+      v.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_ReadAll)->Arg(2)->Arg(4)->Arg(8)->Arg(32)->Arg(1024);
+
+// Measures replacing one element, as an assignment to a tuple element does.
+void BM_Set(benchmark::State& state) {
+  std::vector<const int*> elements = MakeElements(state.range(0));
+  Vector v(elements);
+  size_t index = 0;
+  for (auto _ : state) {
+    Vector updated = v.Set(index, elements[0]);
+    benchmark::DoNotOptimize(updated);
+    index = (index + 1) % v.size();
+  }
+}
+BENCHMARK(BM_Set)->Arg(2)->Arg(4)->Arg(8)->Arg(32)->Arg(1024);
+
+}  // namespace
+}  // namespace Carbon
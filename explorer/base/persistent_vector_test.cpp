@@ -0,0 +1,110 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "explorer/base/persistent_vector.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <vector>
+
+namespace Carbon {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::Optional;
+
+// Returns the elements of `v`.
+auto ToVector(const PersistentVector<int>& v) -> std::vector<int> {
+  std::vector<int> result;
+  v.AppendTo(result);
+  return result;
+}
+
+TEST(PersistentVectorTest, Empty) {
+  PersistentVector<int> v;
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(v.size(), 0);
+  EXPECT_THAT(v.contiguous(), Optional(ElementsAre()));
+  EXPECT_THAT(ToVector(v), ElementsAre());
+}
+
+TEST(PersistentVectorTest, Small) {
+  std::vector<int> elements = {1, 2, 3};
+  PersistentVector<int> v(elements);
+  EXPECT_EQ(v.size(), 3);
+  EXPECT_EQ(v[1], 2);
+  EXPECT_THAT(v.contiguous(), Optional(ElementsAre(1, 2, 3)));
+
+  PersistentVector<int> updated = v.Set(1, 5);
+  EXPECT_THAT(ToVector(updated), ElementsAre(1, 5, 3));
+  EXPECT_THAT(ToVector(v), ElementsAre(1, 2, 3));
+}
+
+TEST(PersistentVectorTest, Large) {
+  // Enough elements for three levels, with partly-filled nodes at the end.
+  constexpr int Size = 2000;
+  std::vector<int> elements(Size);
+  std::iota(elements.begin(), elements.end(), 0);
+  PersistentVector<int> v(elements);
+  EXPECT_EQ(v.size(), Size);
+  EXPECT_EQ(v.contiguous(), std::nullopt);
+  for (int i = 0; i < Size; ++i) {
+    EXPECT_EQ(v[i], i);
+  }
+  EXPECT_THAT(ToVector(v), ElementsAreArray(elements));
+
+  PersistentVector<int> updated = v;
+  for (int i = 0; i < Size; i += 7) {
+    updated = updated.Set(i, -i);
+    elements[i] = -i;
+  }
+  EXPECT_THAT(ToVector(updated), ElementsAreArray(elements));
+  EXPECT_EQ(v[7], 7);
+  EXPECT_EQ(updated[7], -7);
+}
+
+TEST(PersistentVectorTest, InlineBoundary) {
+  // Sizes on either side of the switch from inline storage to a tree.
+  for (size_t size : {PersistentVector<int>::InlineCapacity,
+                      PersistentVector<int>::InlineCapacity + 1}) {
+    SCOPED_TRACE(size);
+    std::vector<int> elements(size);
+    std::iota(elements.begin(), elements.end(), 0);
+    PersistentVector<int> v(elements);
+    EXPECT_THAT(v.contiguous(), Optional(ElementsAreArray(elements)));
+
+    PersistentVector<int> updated = v.Set(size - 1, -1);
+    EXPECT_EQ(updated[size - 1], -1);
+    EXPECT_EQ(v[size - 1], static_cast<int>(size - 1));
+    elements.back() = -1;
+    EXPECT_THAT(ToVector(updated), ElementsAreArray(elements));
+  }
+}
+
+TEST(PersistentVectorTest, InlineEqualityComparesElements) {
+  std::vector<int> elements = {1, 2};
+  PersistentVector<int> v(elements);
+  EXPECT_TRUE(v == PersistentVector<int>(elements));
+  EXPECT_EQ(hash_value(v), hash_value(PersistentVector<int>(elements)));
+  EXPECT_TRUE(v == v.Set(0, 1));
+  EXPECT_FALSE(v == v.Set(0, 3));
+  EXPECT_FALSE(v == PersistentVector<int>());
+}
+
+TEST(PersistentVectorTest, EqualityIsIdentity) {
+  std::vector<int> elements(PersistentVector<int>::InlineCapacity + 1);
+  std::iota(elements.begin(), elements.end(), 0);
+  PersistentVector<int> v(elements);
+  PersistentVector<int> copy = v;
+  EXPECT_TRUE(v == copy);
+  EXPECT_EQ(hash_value(v), hash_value(copy));
+  EXPECT_FALSE(v == PersistentVector<int>(elements));
+  EXPECT_FALSE(v == v.Set(0, 0));
+}
+
+}  // namespace
+}  // namespace Carbon
@@ -50,8 +50,10 @@ auto ParseAndExecuteProto(const Fuzzing::Carbon& carbon) -> ErrorOr<int> {
                           llvm::MemoryBuffer::getMemBuffer(source)));
 
   TraceStream trace_stream;
+  ExecutionReport report;
   return ParseAndExecute(fs, "prelude.carbon", "fuzzer.carbon",
-                         /*parser_debug=*/false, &trace_stream, &llvm::nulls());
+                         /*parser_debug=*/false, ExecutionBudget(),
+                         &trace_stream, &llvm::nulls(), &report);
 }
 
 }  // namespace Carbon::Testing
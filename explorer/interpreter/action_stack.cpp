@@ -5,6 +5,7 @@
 #include "explorer/interpreter/action_stack.h"
 
 #include "common/error.h"
+#include "explorer/ast/declaration.h"
 #include "explorer/interpreter/action.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Casting.h"
@@ -252,6 +253,60 @@ auto ActionStack::UnwindPast(Nonnull<const Statement*> ast_node,
   return Success();
 }
 
+auto ActionStack::TailCallerBody() const -> Nonnull<const Statement*> {
+  // The call is the operand of a `return` statement, so the innermost
+  // statement on the stack is that `return`.
+  for (const std::unique_ptr<Action>& action : todo_) {
+    if (const auto* statement_action =
+            llvm::dyn_cast<StatementAction>(action.get())) {
+      const auto& ret = llvm::cast<Return>(statement_action->statement());
+      return *ret.function().body();
+    }
+  }
+  CARBON_FATAL() << "Tail call outside of a function body";
+}
+
+auto ActionStack::CanTailCall() const -> bool {
+  Nonnull<const Statement*> caller_body = TailCallerBody();
+  bool in_caller_scopes = false;
+  for (const std::unique_ptr<Action>& action : todo_) {
+    if (action.get() == todo_.Top().get()) {
+      // The call's own scope is moved to the callee.
+      continue;
+    }
+    if (in_caller_scopes && !llvm::isa<ScopeAction>(*action)) {
+      break;
+    }
+    if (action->scope() && !action->scope()->allocations().empty()) {
+      return false;
+    }
+    if (const auto* statement_action =
+            llvm::dyn_cast<StatementAction>(action.get());
+        statement_action != nullptr &&
+        &statement_action->statement() == caller_body) {
+      in_caller_scopes = true;
+    }
+  }
+  return true;
+}
+
+auto ActionStack::TailCall(Nonnull<const Statement*> callee_body,
+                           RuntimeScope callee_scope) -> ErrorOr<Success> {
+  Nonnull<const Statement*> caller_body = TailCallerBody();
+  callee_scope.Merge(std::move(*CurrentAction().scope()));
+  std::stack<std::unique_ptr<Action>> scopes_to_destroy =
+      UnwindToWithCaptureScopesToDestroy(caller_body);
+  auto location_received =
+      llvm::cast<StatementAction>(*todo_.Top()).location_received();
+  scopes_to_destroy.push(Pop());
+  PopScopes(scopes_to_destroy);
+  Push(std::make_unique<ScopeAction>(std::move(callee_scope)));
+  Push(std::make_unique<StatementAction>(callee_body, location_received));
+  // Clean-ups for the replaced frame run first.
+  PushCleanUpActions(std::move(scopes_to_destroy));
+  return Success();
+}
+
 void ActionStack::PopScopes(
     std::stack<std::unique_ptr<Action>>& cleanup_stack) {
   while (!todo_.empty() && llvm::isa<ScopeAction>(*todo_.Top())) {
@@ -44,6 +44,14 @@ class ActionStack : public Printable<ActionStack> {
   // True if the stack is empty.
   auto empty() const -> bool { return todo_.empty(); }
 
+  // Discards all pending actions without running them or their clean-up, so
+  // that execution can be started again after an error. Global variables are
+  // kept.
+  void Abandon() {
+    todo_.Pop(todo_.size());
+    result_ = std::nullopt;
+  }
+
   // The Action currently at the top of the stack. This will never be a
   // ScopeAction.
   auto CurrentAction() -> Action& { return *todo_.Top(); }
@@ -108,6 +116,21 @@ class ActionStack : public Printable<ActionStack> {
   auto UnwindPast(Nonnull<const Statement*> ast_node,
                   Nonnull<const Value*> result) -> ErrorOr<Success>;
 
+  // Returns whether the current action, which must be a call in tail position,
+  // can reuse the frame of the function it returns from. This requires that
+  // no scope in that frame, other than the call's own, owns any storage, as
+  // the callee might still refer to it.
+  auto CanTailCall() const -> bool;
+
+  // Replaces the frame of the function that the current action, a call in
+  // tail position, returns from with a frame running `callee_body` in
+  // `callee_scope`. The call's own scope is merged into `callee_scope`. The
+  // replaced frame is cleaned up before `callee_body` starts, and the callee's
+  // result is delivered wherever the replaced function's would have been. Can
+  // only be called if CanTailCall() is true.
+  auto TailCall(Nonnull<const Statement*> callee_body,
+                RuntimeScope callee_scope) -> ErrorOr<Success>;
+
   auto Pop() -> std::unique_ptr<Action> {
     auto popped_action = todo_.Pop();
     if (trace_stream_->is_enabled()) {
@@ -144,6 +167,10 @@ class ActionStack : public Printable<ActionStack> {
   auto UnwindPastWithCaptureScopesToDestroy(Nonnull<const Statement*> ast_node)
       -> std::stack<std::unique_ptr<Action>>;
 
+  // Returns the body of the function that the current action, a call in tail
+  // position, returns from.
+  auto TailCallerBody() const -> Nonnull<const Statement*>;
+
   // Create CleanUpActions for all actions
   void PushCleanUpActions(std::stack<std::unique_ptr<Action>> actions);
 
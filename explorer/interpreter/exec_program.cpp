@@ -89,16 +89,17 @@ auto AnalyzeProgram(Nonnull<Arena*> arena, AST ast,
   return ast;
 }
 
-auto ExecProgram(Nonnull<Arena*> arena, AST ast,
+auto ExecProgram(Nonnull<Arena*> arena, AST ast, const ExecutionBudget& budget,
                  Nonnull<TraceStream*> trace_stream,
-                 Nonnull<llvm::raw_ostream*> print_stream) -> ErrorOr<int> {
+                 Nonnull<llvm::raw_ostream*> print_stream,
+                 Nonnull<ExecutionReport*> report) -> ErrorOr<int> {
   SetProgramPhase set_program_phase(*trace_stream, ProgramPhase::Execution);
   if (trace_stream->is_enabled()) {
     trace_stream->Heading("starting execution");
   }
   CARBON_ASSIGN_OR_RETURN(
       auto interpreter_result,
-      InterpProgram(ast, arena, trace_stream, print_stream));
+      InterpProgram(ast, arena, budget, trace_stream, print_stream, report));
   if (trace_stream->is_enabled()) {
     trace_stream->Result() << "interpreter result: " << interpreter_result
                            << "\n";
@@ -106,4 +107,66 @@ auto ExecProgram(Nonnull<Arena*> arena, AST ast,
   return interpreter_result;
 }
 
+IncrementalProgram::IncrementalProgram(Nonnull<Arena*> arena,
+                                       Nonnull<TraceStream*> trace_stream,
+                                       Nonnull<llvm::raw_ostream*> print_stream)
+    : trace_stream_(trace_stream),
+      name_resolver_(trace_stream),
+      type_checker_(arena, trace_stream, print_stream),
+      interpreter_(arena, ExecutionBudget(), trace_stream, print_stream) {}
+
+auto IncrementalProgram::AnalyzeFragment(AST& fragment) -> ErrorOr<Success> {
+  SetProgramPhase set_prog_phase(*trace_stream_, ProgramPhase::NameResolution);
+  CARBON_RETURN_IF_ERROR(
+      name_resolver_.ResolveNames(fragment.declarations, fragment.main_call));
+
+  impl_scope_checkpoint_ = impl_scope_;
+  ErrorOr<Success> result = [&]() -> ErrorOr<Success> {
+    set_prog_phase.update_phase(ProgramPhase::ControlFlowResolution);
+    CARBON_RETURN_IF_ERROR(
+        ResolveControlFlow(trace_stream_, fragment.declarations));
+
+    set_prog_phase.update_phase(ProgramPhase::TypeChecking);
+    CARBON_RETURN_IF_ERROR(type_checker_.TypeCheckFragment(
+        fragment.declarations, fragment.main_call, impl_scope_));
+
+    set_prog_phase.update_phase(ProgramPhase::UnformedVariableResolution);
+    return ResolveUnformed(trace_stream_, fragment.declarations);
+  }();
+  if (!result.ok()) {
+    Rollback();
+  }
+  return result;
+}
+
+auto IncrementalProgram::ExecFragment(const AST& fragment)
+    -> ErrorOr<std::optional<Nonnull<const Value*>>> {
+  SetProgramPhase set_program_phase(*trace_stream_, ProgramPhase::Execution);
+  SetFileContext set_file_ctx(*trace_stream_, std::nullopt);
+  interpreter_.StartFragment();
+  ErrorOr<std::optional<Nonnull<const Value*>>> result =
+      [&]() -> ErrorOr<std::optional<Nonnull<const Value*>>> {
+    for (Nonnull<Declaration*> declaration : fragment.declarations) {
+      set_file_ctx.update_source_loc(declaration->source_loc());
+      CARBON_RETURN_IF_ERROR(interpreter_.RunDeclaration(declaration));
+    }
+    std::optional<Nonnull<const Value*>> value;
+    if (fragment.main_call) {
+      set_file_ctx.update_source_loc((*fragment.main_call)->source_loc());
+      CARBON_ASSIGN_OR_RETURN(value,
+                              interpreter_.RunExpression(*fragment.main_call));
+    }
+    return value;
+  }();
+  if (!result.ok()) {
+    Rollback();
+  }
+  return result;
+}
+
+void IncrementalProgram::Rollback() {
+  name_resolver_.Rollback();
+  impl_scope_ = impl_scope_checkpoint_;
+}
+
 }  // namespace Carbon
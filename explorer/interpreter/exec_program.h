@@ -9,8 +9,14 @@
 #ifndef CARBON_EXPLORER_INTERPRETER_EXEC_PROGRAM_H_
 #define CARBON_EXPLORER_INTERPRETER_EXEC_PROGRAM_H_
 
+#include <optional>
+
 #include "explorer/ast/ast.h"
 #include "explorer/base/trace_stream.h"
+#include "explorer/interpreter/impl_scope.h"
+#include "explorer/interpreter/interpreter.h"
+#include "explorer/interpreter/resolve_names.h"
+#include "explorer/interpreter/type_checker.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace Carbon {
@@ -20,10 +26,44 @@ auto AnalyzeProgram(Nonnull<Arena*> arena, AST ast,
                     Nonnull<TraceStream*> trace_stream,
                     Nonnull<llvm::raw_ostream*> print_stream) -> ErrorOr<AST>;
 
-// Run the program's `Main` function.
-auto ExecProgram(Nonnull<Arena*> arena, AST ast,
+// Run the program's `Main` function within `budget`, storing the resources used
+// in `report`.
+auto ExecProgram(Nonnull<Arena*> arena, AST ast, const ExecutionBudget& budget,
                  Nonnull<TraceStream*> trace_stream,
-                 Nonnull<llvm::raw_ostream*> print_stream) -> ErrorOr<int>;
+                 Nonnull<llvm::raw_ostream*> print_stream,
+                 Nonnull<ExecutionReport*> report) -> ErrorOr<int>;
+
+// A program that's analyzed and executed one fragment at a time, such as in an
+// interactive session. Each fragment is processed in the context of the
+// fragments before it, and only the new fragment is analyzed and executed.
+class IncrementalProgram {
+ public:
+  IncrementalProgram(Nonnull<Arena*> arena, Nonnull<TraceStream*> trace_stream,
+                     Nonnull<llvm::raw_ostream*> print_stream);
+
+  // Analyzes the declarations of `fragment`, followed by its `main_call` if it
+  // has one. On failure, the program is left as it was before the fragment.
+  auto AnalyzeFragment(AST& fragment) -> ErrorOr<Success>;
+
+  // Executes the most recently analyzed fragment: initializes the global
+  // variables it declares, then evaluates its `main_call` if it has one and
+  // returns the result. On failure, the names the fragment declared are
+  // forgotten, although any effects it already had are not undone.
+  auto ExecFragment(const AST& fragment)
+      -> ErrorOr<std::optional<Nonnull<const Value*>>>;
+
+ private:
+  // Forgets the names and impls declared by the most recent fragment.
+  void Rollback();
+
+  Nonnull<TraceStream*> trace_stream_;
+  IncrementalNameResolver name_resolver_;
+  TypeChecker type_checker_;
+  // The top-level impl scope, and its state before the most recent fragment.
+  ImplScope impl_scope_;
+  ImplScope impl_scope_checkpoint_;
+  IncrementalInterpreter interpreter_;
+};
 
 }  // namespace Carbon
 
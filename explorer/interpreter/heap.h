@@ -67,6 +67,9 @@ class Heap : public HeapAllocationInterface, public Printable<Heap> {
   // Returns whether the given allocation was initialized.
   auto is_initialized(AllocationId allocation) const -> bool;
 
+  // Returns the number of allocations made, including those since deallocated.
+  auto num_allocations() const -> int64_t { return values_.size(); }
+
   // Print all the values on the heap to the stream `out`.
   void Print(llvm::raw_ostream& out) const;
 
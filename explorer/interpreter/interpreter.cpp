@@ -4,6 +4,7 @@
 
 #include "explorer/interpreter/interpreter.h"
 
+#include <algorithm>
 #include <iterator>
 #include <limits>
 #include <map>
@@ -33,10 +34,12 @@
 #include "explorer/interpreter/type_utils.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Casting.h"
-#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/raw_ostream.h"
 
 using llvm::cast;
@@ -45,10 +48,9 @@ using llvm::isa;
 
 namespace Carbon {
 
-// Limits for various overflow conditions.
-static constexpr int64_t MaxTodoSize = 1e3;
-static constexpr int64_t MaxStepsTaken = 1e6;
-static constexpr int64_t MaxArenaAllocated = 1e9;
+// The number of receiver types an interface member access caches members for
+// before it is considered megamorphic, and stops caching.
+static constexpr int MaxMemberCacheEntries = 4;
 
 // Constructs an ActionStack suitable for the specified phase.
 static auto MakeTodo(Phase phase, Nonnull<Heap*> heap,
@@ -68,11 +70,13 @@ class Interpreter {
  public:
   // Constructs an Interpreter which allocates values on `arena`, and prints
   // traces if `trace` is true. `phase` indicates whether it executes at
-  // compile time or run time.
+  // compile time or run time. Exceeding `budget` is an error.
   Interpreter(Phase phase, Nonnull<Arena*> arena,
+              const ExecutionBudget& budget,
               Nonnull<TraceStream*> trace_stream,
               Nonnull<llvm::raw_ostream*> print_stream)
       : arena_(arena),
+        budget_(budget),
         heap_(trace_stream, arena),
         todo_(MakeTodo(phase, &heap_, trace_stream)),
         trace_stream_(trace_stream),
@@ -88,6 +92,25 @@ class Interpreter {
   // produce results.
   auto result() const -> Nonnull<const Value*> { return todo_.result(); }
 
+  // Prepares to run another fragment of an incrementally-executed program:
+  // drops anything left behind by a fragment that failed, and restarts the
+  // step count. The heap and global variables are kept.
+  void StartFragment() {
+    todo_.Abandon();
+    steps_taken_ = 0;
+    max_todo_size_ = 0;
+  }
+
+  // Returns the resources used so far.
+  auto usage() const -> ExecutionReport {
+    ExecutionReport report;
+    report.steps = steps_taken_;
+    report.max_action_depth = max_todo_size_;
+    report.arena_bytes = arena_->allocated();
+    report.heap_cells = heap_.num_allocations();
+    return report;
+  }
+
  private:
   auto Step() -> ErrorOr<Success>;
 
@@ -194,10 +217,44 @@ class Interpreter {
                          BindingMap& generic_args,
                          const SourceLocation& source_location);
 
+  // An impl function found by an interface member access, and the arguments
+  // of the impl it was found in.
+  struct CachedMember {
+    Nonnull<const FunctionDeclaration*> function;
+    Nonnull<const Bindings*> bindings;
+  };
+
+  // Returns the impl function that an earlier evaluation of the interface
+  // member access `access` found for a receiver of the same type as
+  // `receiver`, if cached.
+  auto FindCachedMember(Nonnull<const Expression*> access,
+                        Nonnull<const Value*> receiver) const
+      -> std::optional<CachedMember>;
+
+  // Records that `access` evaluated to `member` for `receiver`, so that later
+  // evaluations for a receiver of the same type can skip evaluating the witness
+  // and looking up the member.
+  void CacheMember(Nonnull<const Expression*> access,
+                   Nonnull<const Value*> receiver,
+                   Nonnull<const Value*> member);
+
   auto phase() const -> Phase { return phase_; }
 
+  // An inline cache for an interface member access, mapping each receiver type
+  // that the access has been evaluated for to the impl function it found.
+  struct MemberCache {
+    llvm::SmallVector<std::pair<Nonnull<const Value*>, CachedMember>,
+                      MaxMemberCacheEntries>
+        entries;
+    // Set once the access has seen more than `MaxMemberCacheEntries` receiver
+    // types.
+    bool megamorphic = false;
+  };
+
   Nonnull<Arena*> arena_;
 
+  ExecutionBudget budget_;
+
   Heap heap_;
   ActionStack todo_;
 
@@ -211,8 +268,85 @@ class Interpreter {
   // The number of steps taken by the interpreter. Used for infinite loop
   // detection.
   int64_t steps_taken_ = 0;
+
+  // The largest size of `todo_` seen by `Step`.
+  int64_t max_todo_size_ = 0;
+
+  // Inline caches for interface member accesses, keyed by the access
+  // expression.
+  llvm::DenseMap<const Expression*, MemberCache> member_caches_;
 };
 
+// Returns whether the interface member access `access` always finds the same
+// impl function for receivers of the same type. This is the case when it
+// accesses a member of an object, rather than of a type, through an impl of an
+// interface that has no arguments, so that the receiver's type alone
+// determines the impl.
+static auto IsMemberCacheable(
+    Nonnull<const Expression*> access,
+    std::optional<Nonnull<const InterfaceType*>> interface) -> bool {
+  if (!interface || !(*interface)->args().empty()) {
+    return false;
+  }
+  if (const auto* simple = dyn_cast<SimpleMemberAccessExpression>(access)) {
+    return simple->impl().has_value() && !simple->is_type_access();
+  }
+  const auto& compound = cast<CompoundMemberAccessExpression>(*access);
+  return compound.impl().has_value() && !compound.is_type_access();
+}
+
+// Returns the type of `receiver` if it's cheaply known: currently, only a class
+// object knows its type, including the class's arguments.
+static auto GetReceiverType(Nonnull<const Value*> receiver)
+    -> std::optional<Nonnull<const Value*>> {
+  if (const auto* object = dyn_cast<NominalClassValue>(receiver)) {
+    return &object->type();
+  }
+  return std::nullopt;
+}
+
+auto Interpreter::FindCachedMember(Nonnull<const Expression*> access,
+                                   Nonnull<const Value*> receiver) const
+    -> std::optional<CachedMember> {
+  auto it = member_caches_.find(access);
+  if (it == member_caches_.end()) {
+    return std::nullopt;
+  }
+  std::optional<Nonnull<const Value*>> receiver_type =
+      GetReceiverType(receiver);
+  if (!receiver_type) {
+    return std::nullopt;
+  }
+  for (const auto& [type, member] : it->second.entries) {
+    if (TypeEqual(type, *receiver_type, std::nullopt)) {
+      return member;
+    }
+  }
+  return std::nullopt;
+}
+
+void Interpreter::CacheMember(Nonnull<const Expression*> access,
+                              Nonnull<const Value*> receiver,
+                              Nonnull<const Value*> member) {
+  std::optional<Nonnull<const Value*>> receiver_type =
+      GetReceiverType(receiver);
+  const auto* function = dyn_cast<FunctionOrMethodValue>(member);
+  if (!receiver_type || !function) {
+    return;
+  }
+  MemberCache& cache = member_caches_[access];
+  if (cache.megamorphic) {
+    return;
+  }
+  if (static_cast<int>(cache.entries.size()) == MaxMemberCacheEntries) {
+    cache.entries.clear();
+    cache.megamorphic = true;
+    return;
+  }
+  cache.entries.push_back(
+      {*receiver_type, {&function->declaration(), &function->bindings()}});
+}
+
 //
 // State Operations
 //
@@ -279,19 +413,52 @@ auto Interpreter::EvalPrim(Operator op, Nonnull<const Value*> /*static_type*/,
     }
     case Operator::AddressOf:
       return arena_->New<PointerValue>(cast<LocationValue>(*args[0]).address());
-    case Operator::As:
     case Operator::Eq:
-    case Operator::NotEq:
+    case Operator::NotEq: {
+      // Only `i32` and `bool` equality is built in.
+      bool equal = isa<IntValue>(args[0])
+                       ? cast<IntValue>(*args[0]).value() ==
+                             cast<IntValue>(*args[1]).value()
+                       : cast<BoolValue>(*args[0]).value() ==
+                             cast<BoolValue>(*args[1]).value();
+      return arena_->New<BoolValue>(equal == (op == Operator::Eq));
+    }
     case Operator::Less:
+      return arena_->New<BoolValue>(cast<IntValue>(*args[0]).value() <
+                                    cast<IntValue>(*args[1]).value());
     case Operator::LessEq:
+      return arena_->New<BoolValue>(cast<IntValue>(*args[0]).value() <=
+                                    cast<IntValue>(*args[1]).value());
     case Operator::Greater:
+      return arena_->New<BoolValue>(cast<IntValue>(*args[0]).value() >
+                                    cast<IntValue>(*args[1]).value());
     case Operator::GreaterEq:
+      return arena_->New<BoolValue>(cast<IntValue>(*args[0]).value() >=
+                                    cast<IntValue>(*args[1]).value());
+    case Operator::Complement:
+      return arena_->New<IntValue>(~cast<IntValue>(*args[0]).value());
     case Operator::BitwiseAnd:
+      return arena_->New<IntValue>(cast<IntValue>(*args[0]).value() &
+                                   cast<IntValue>(*args[1]).value());
     case Operator::BitwiseOr:
+      return arena_->New<IntValue>(cast<IntValue>(*args[0]).value() |
+                                   cast<IntValue>(*args[1]).value());
     case Operator::BitwiseXor:
+      return arena_->New<IntValue>(cast<IntValue>(*args[0]).value() ^
+                                   cast<IntValue>(*args[1]).value());
     case Operator::BitShiftLeft:
-    case Operator::BitShiftRight:
-    case Operator::Complement:
+    case Operator::BitShiftRight: {
+      const auto& lhs = cast<IntValue>(*args[0]).value();
+      const auto& rhs = cast<IntValue>(*args[1]).value();
+      if (rhs < 0 || rhs >= 32) {
+        return ProgramError(source_loc) << "Integer overflow";
+      }
+      if (op == Operator::BitShiftLeft) {
+        return arena_->New<IntValue>(static_cast<uint32_t>(lhs) << rhs);
+      }
+      return arena_->New<IntValue>(lhs >> rhs);
+    }
+    case Operator::As:
       CARBON_FATAL() << "operator " << OperatorToString(op)
                      << " should always be rewritten";
   }
@@ -946,6 +1113,11 @@ auto Interpreter::CallFunction(const CallExpression& call,
                                   call.source_loc(), &function_scope,
                                   generic_args, trace_stream_, this->arena_);
       CARBON_CHECK(success) << "Failed to bind arguments to parameters";
+      if (call.is_tail_call() && todo_.CanTailCall()) {
+        // Reuse the caller's frame, so that tail recursion runs in constant
+        // stack space.
+        return todo_.TailCall(*function.body(), std::move(function_scope));
+      }
       return todo_.Spawn(std::make_unique<StatementAction>(*function.body(),
                                                            location_received),
                          std::move(function_scope));
@@ -1040,64 +1212,69 @@ void Interpreter::BindSelfIfPresent(Nonnull<const CallableDeclaration*> decl,
   }
 }
 
-// Returns true if the format string is okay to pass to formatv. This only
-// supports `{{` and `{N}` as special syntax.
-static auto ValidateFormatString(SourceLocation source_loc,
-                                 const char* format_string, int num_args)
-    -> ErrorOr<Success> {
-  const char* cursor = format_string;
+auto ParsePrintFormat(SourceLocation source_loc, std::string_view format_string,
+                      int num_args) -> ErrorOr<std::vector<PrintFormatSegment>> {
+  std::vector<PrintFormatSegment> segments(1);
+  size_t cursor = 0;
   while (true) {
-    switch (*cursor) {
-      case '\0':
-        // End of string.
-        return Success();
+    if (cursor == format_string.size()) {
+      // End of string.
+      if (segments.back().text.empty() && segments.size() > 1) {
+        segments.pop_back();
+      }
+      return segments;
+    }
+    if (format_string[cursor] != '{') {
+      // Arbitrary text.
+      segments.back().text += format_string[cursor];
+      ++cursor;
+      continue;
+    }
+    // `{` is a special character.
+    ++cursor;
+    if (cursor == format_string.size()) {
+      return ProgramError(source_loc)
+             << "`{` must be followed by a second `{` or index in `"
+             << format_string << "`";
+    }
+    switch (format_string[cursor]) {
       case '{':
-        // `{` is a special character.
+        // Escaped `{`.
+        segments.back().text += '{';
         ++cursor;
-        switch (*cursor) {
-          case '\0':
+        break;
+      case '}':
+        return ProgramError(source_loc)
+               << "Invalid `{}` in `" << format_string << "`";
+      default:
+        int index = 0;
+        while (cursor == format_string.size() ||
+               format_string[cursor] != '}') {
+          if (cursor == format_string.size()) {
             return ProgramError(source_loc)
-                   << "`{` must be followed by a second `{` or index in `"
-                   << format_string << "`";
-          case '{':
-            // Escaped `{`.
-            ++cursor;
-            break;
-          case '}':
+                   << "Index incomplete in `" << format_string << "`";
+          }
+          char digit = format_string[cursor];
+          if (digit < '0' || digit > '9') {
             return ProgramError(source_loc)
-                   << "Invalid `{}` in `" << format_string << "`";
-          default:
-            int index = 0;
-            while (*cursor != '}') {
-              if (*cursor == '\0') {
-                return ProgramError(source_loc)
-                       << "Index incomplete in `" << format_string << "`";
-              }
-              if (*cursor < '0' || *cursor > '9') {
-                return ProgramError(source_loc)
-                       << "Non-numeric character in index at offset "
-                       << cursor - format_string << " in `" << format_string
-                       << "`";
-              }
-              index = (10 * index) + (*cursor - '0');
-              if (index >= num_args) {
-                return ProgramError(source_loc)
-                       << "Index invalid with argument count of " << num_args
-                       << " at offset " << cursor - format_string << " in `"
-                       << format_string << "`";
-              }
-              ++cursor;
-            }
-            // Move past the `}`.
-            ++cursor;
+                   << "Non-numeric character in index at offset " << cursor
+                   << " in `" << format_string << "`";
+          }
+          index = (10 * index) + (digit - '0');
+          if (index >= num_args) {
+            return ProgramError(source_loc)
+                   << "Index invalid with argument count of " << num_args
+                   << " at offset " << cursor << " in `" << format_string
+                   << "`";
+          }
+          ++cursor;
         }
-        break;
-      default:
-        // Arbitrary text.
+        // Move past the `}`.
         ++cursor;
+        segments.back().arg_index = index;
+        segments.push_back({});
     }
   }
-  llvm_unreachable("Loop returns directly");
 }
 
 auto Interpreter::StepInstantiateType() -> ErrorOr<Success> {
@@ -1176,6 +1353,23 @@ auto Interpreter::StepExp() -> ErrorOr<Success> {
       } else {
         //    { { v :: [][i] :: C, E, F} :: S, H}
         // -> { { v_i :: C, E, F} : S, H}
+        const Value& object_type =
+            cast<IndexExpression>(exp).object().static_type();
+        if (const auto* array_type = dyn_cast<StaticArrayType>(&object_type);
+            array_type && isa<TupleValue>(act.results()[0])) {
+          // Convert only the element being read, rather than the whole array.
+          const auto& array = cast<TupleValue>(*act.results()[0]);
+          int i = cast<IntValue>(*act.results()[1]).value();
+          if (i < 0 || i >= static_cast<int>(array.num_elements())) {
+            return ProgramError(exp.source_loc())
+                   << "index " << i << " out of range in " << array;
+          }
+          CARBON_ASSIGN_OR_RETURN(
+              Nonnull<const Value*> element,
+              Convert(array.element(i), &array_type->element_type(),
+                      exp.source_loc()));
+          return todo_.FinishAction(element);
+        }
         CARBON_ASSIGN_OR_RETURN(
             auto converted,
             Convert(act.results()[0],
@@ -1273,7 +1467,12 @@ auto Interpreter::StepExp() -> ErrorOr<Success> {
           // The result is the value of the named field, such as in
           // `value.field_name`. Extract the value within the given object.
           auto impl_has_value = access.impl().has_value();
-          if (act.pos() == 1) {
+          // An `addr` method's receiver is a location, and finding its type
+          // would need an extra read of the heap, so it isn't cached.
+          bool cacheable =
+              IsMemberCacheable(&access, access.found_in_interface()) &&
+              !access.is_addr_me_method();
+          if (act.pos() == 1 && !cacheable) {
             // Next, if we're accessing an interface member, evaluate the `impl`
             // expression to find the corresponding witness.
             if (impl_has_value) {
@@ -1297,17 +1496,6 @@ auto Interpreter::StepExp() -> ErrorOr<Success> {
               return todo_.RunAgain();
             }
           } else {
-            auto found_in_interface = access.found_in_interface();
-            if (found_in_interface) {
-              found_in_interface = cast<InterfaceType>(
-                  impl_has_value ? act.results()[2] : act.results()[1]);
-            }
-            std::optional<Nonnull<const Witness*>> witness;
-            if (access.impl().has_value()) {
-              witness = cast<Witness>(act.results()[1]);
-            }
-            ElementPath::Component member(&access.member(), found_in_interface,
-                                          witness);
             const Value* aggregate;
             std::optional<Nonnull<const Value*>> me_value;
             std::optional<Address> lhs_address;
@@ -1330,13 +1518,41 @@ auto Interpreter::StepExp() -> ErrorOr<Success> {
               aggregate = act.results()[0];
               me_value = aggregate;
             }
-            CARBON_ASSIGN_OR_RETURN(
-                Nonnull<const Value*> member_value,
-                aggregate->GetElement(arena_, ElementPath(member),
-                                      exp.source_loc(), me_value));
+            const Value* member_value;
+            if (act.pos() == 1) {
+              // If an earlier evaluation found the member for an object of this
+              // type, neither the witness nor the interface is needed.
+              auto cached_member = FindCachedMember(&access, aggregate);
+              if (!cached_member) {
+                return todo_.Spawn(std::make_unique<WitnessAction>(
+                    access.impl().value(), access.source_loc()));
+              }
+              member_value =
+                  MakeImplMemberValue(arena_, cached_member->function,
+                                      cached_member->bindings, me_value);
+            } else {
+              auto found_in_interface = access.found_in_interface();
+              if (found_in_interface) {
+                found_in_interface = cast<InterfaceType>(
+                    impl_has_value ? act.results()[2] : act.results()[1]);
+              }
+              std::optional<Nonnull<const Witness*>> witness;
+              if (access.impl().has_value()) {
+                witness = cast<Witness>(act.results()[1]);
+              }
+              ElementPath::Component member(&access.member(),
+                                            found_in_interface, witness);
+              CARBON_ASSIGN_OR_RETURN(
+                  member_value,
+                  aggregate->GetElement(arena_, ElementPath(member),
+                                        exp.source_loc(), me_value));
+              if (cacheable) {
+                CacheMember(&access, aggregate, member_value);
+              }
+            }
             if (lhs_address) {
               return todo_.FinishAction(arena_->New<ReferenceExpressionValue>(
-                  member_value, lhs_address->ElementAddress(member.element())));
+                  member_value, lhs_address->ElementAddress(&access.member())));
             } else {
               return todo_.FinishAction(member_value);
             }
@@ -1388,7 +1604,12 @@ auto Interpreter::StepExp() -> ErrorOr<Success> {
           }
         } else {
           auto impl_has_value = access.impl().has_value();
-          if (act.pos() == 1) {
+          // An `addr` method's receiver is a location, and finding its type
+          // would need an extra read of the heap, so it isn't cached.
+          bool cacheable =
+              IsMemberCacheable(&access, access.member().interface()) &&
+              !access.is_addr_me_method();
+          if (act.pos() == 1 && !cacheable) {
             if (impl_has_value) {
               // Next, if we're accessing an interface member, evaluate the
               // `impl` expression to find the corresponding witness.
@@ -1413,16 +1634,28 @@ auto Interpreter::StepExp() -> ErrorOr<Success> {
             }
           } else {
             // Access the object to find the named member.
+            Nonnull<const Value*> object = act.results()[0];
+            if (access.is_type_access()) {
+              object = act.results().back();
+            }
+            if (act.pos() == 1) {
+              // If an earlier evaluation found the member for an object of this
+              // type, neither the witness nor the interface is needed.
+              auto cached_member = FindCachedMember(&access, object);
+              if (!cached_member) {
+                return todo_.Spawn(std::make_unique<WitnessAction>(
+                    access.impl().value(), access.source_loc()));
+              }
+              return todo_.FinishAction(
+                  MakeImplMemberValue(arena_, cached_member->function,
+                                      cached_member->bindings, object));
+            }
             auto found_in_interface = access.member().interface();
             if (found_in_interface) {
               found_in_interface = cast<InterfaceType>(
                   impl_has_value ? act.results()[2] : act.results()[1]);
             }
 
-            Nonnull<const Value*> object = act.results()[0];
-            if (access.is_type_access()) {
-              object = act.results().back();
-            }
             std::optional<Nonnull<const Witness*>> witness;
             if (access.impl().has_value()) {
               witness = cast<Witness>(act.results()[1]);
@@ -1439,6 +1672,9 @@ auto Interpreter::StepExp() -> ErrorOr<Success> {
                 Nonnull<const Value*> member,
                 object->GetElement(arena_, ElementPath(field), exp.source_loc(),
                                    object));
+            if (cacheable) {
+              CacheMember(&access, object, member);
+            }
             return todo_.FinishAction(member);
           }
         }
@@ -1604,25 +1840,26 @@ auto Interpreter::StepExp() -> ErrorOr<Success> {
             return ProgramError(exp.source_loc())
                    << "Print called before run time";
           }
-          CARBON_ASSIGN_OR_RETURN(
-              Nonnull<const Value*> format_string_value,
-              Convert(args[0], arena_->New<StringType>(), exp.source_loc()));
-          const char* format_string =
-              cast<StringValue>(*format_string_value).value().c_str();
-          int num_format_args = args.size() - 1;
-          CARBON_RETURN_IF_ERROR(ValidateFormatString(
-              intrinsic.source_loc(), format_string, num_format_args));
-          switch (num_format_args) {
-            case 0:
-              *print_stream_ << llvm::formatv(format_string);
-              break;
-            case 1: {
-              *print_stream_ << llvm::formatv(format_string,
-                                              cast<IntValue>(*args[1]).value());
-              break;
+          std::optional<llvm::ArrayRef<PrintFormatSegment>> segments =
+              intrinsic.print_format();
+          std::vector<PrintFormatSegment> parsed_segments;
+          if (!segments) {
+            CARBON_ASSIGN_OR_RETURN(
+                Nonnull<const Value*> format_string_value,
+                Convert(args[0], arena_->New<StringType>(), exp.source_loc()));
+            CARBON_ASSIGN_OR_RETURN(
+                parsed_segments,
+                ParsePrintFormat(intrinsic.source_loc(),
+                                 cast<StringValue>(*format_string_value).value(),
+                                 args.size() - 1));
+            segments = parsed_segments;
+          }
+          for (const PrintFormatSegment& segment : *segments) {
+            *print_stream_ << segment.text;
+            if (segment.arg_index) {
+              *print_stream_
+                  << cast<IntValue>(*args[1 + *segment.arg_index]).value();
             }
-            default:
-              CARBON_FATAL() << "Too many format args: " << num_format_args;
           }
           // Implicit newline; currently no way to disable it.
           *print_stream_ << "\n";
@@ -2044,14 +2281,14 @@ auto Interpreter::StepStmt() -> ErrorOr<Success> {
             cast<TupleValue>(act.results()[TargetVarPosInResult]);
 
         int start_index = 0;
-        auto end_index = static_cast<int>(source_array->elements().size());
+        auto end_index = static_cast<int>(source_array->num_elements());
         if (end_index == 0) {
           return todo_.FinishAction();
         }
         act.AddResult(arena_->New<IntValue>(start_index));
         act.AddResult(arena_->New<IntValue>(end_index));
         todo_.Initialize(*(loop_var->value_node()),
-                         source_array->elements()[start_index]);
+                         source_array->element(start_index));
         act.ReplaceResult(CurrentIndexPosInResult,
                           arena_->New<IntValue>(start_index + 1));
         return todo_.Spawn(std::make_unique<StatementAction>(
@@ -2073,7 +2310,7 @@ auto Interpreter::StepStmt() -> ErrorOr<Success> {
 
           const auto* location = cast<LocationValue>(assigned_array_element);
           CARBON_RETURN_IF_ERROR(heap_.Write(
-              location->address(), source_array->elements()[current_index],
+              location->address(), source_array->element(current_index),
               stmt.source_loc()));
 
           act.ReplaceResult(CurrentIndexPosInResult,
@@ -2536,17 +2773,22 @@ auto Interpreter::Step() -> ErrorOr<Success> {
   };
 
   // Check for various overflow conditions before stepping.
-  if (todo_.size() > MaxTodoSize) {
+  max_todo_size_ = std::max<int64_t>(max_todo_size_, todo_.size());
+  if (todo_.size() > budget_.max_action_depth) {
     return error_builder()
            << "stack overflow: too many interpreter actions on stack";
   }
-  if (++steps_taken_ > MaxStepsTaken) {
+  if (steps_taken_ >= budget_.max_steps) {
     return error_builder()
            << "possible infinite loop: too many interpreter steps executed";
   }
-  if (arena_->allocated() > MaxArenaAllocated) {
+  if (arena_->allocated() > budget_.max_arena_bytes) {
     return error_builder() << "out of memory: exceeded arena allocation limit";
   }
+  if (heap_.num_allocations() > budget_.max_heap_cells) {
+    return error_builder() << "out of memory: exceeded heap allocation limit";
+  }
+  ++steps_taken_;
 
   switch (act.kind()) {
     case Action::Kind::LocationAction:
@@ -2593,10 +2835,50 @@ auto Interpreter::RunAllSteps(std::unique_ptr<Action> action)
   return Success();
 }
 
+IncrementalInterpreter::IncrementalInterpreter(
+    Nonnull<Arena*> arena, const ExecutionBudget& budget,
+    Nonnull<TraceStream*> trace_stream,
+    Nonnull<llvm::raw_ostream*> print_stream)
+    : interpreter_(std::make_unique<Interpreter>(
+          Phase::RunTime, arena, budget, trace_stream, print_stream)) {}
+
+IncrementalInterpreter::~IncrementalInterpreter() = default;
+
+void IncrementalInterpreter::StartFragment() { interpreter_->StartFragment(); }
+
+auto IncrementalInterpreter::usage() const -> ExecutionReport {
+  return interpreter_->usage();
+}
+
+auto IncrementalInterpreter::RunDeclaration(Nonnull<Declaration*> declaration)
+    -> ErrorOr<Success> {
+  return interpreter_->RunAllSteps(
+      std::make_unique<DeclarationAction>(declaration));
+}
+
+auto IncrementalInterpreter::RunExpression(
+    Nonnull<const Expression*> expression) -> ErrorOr<Nonnull<const Value*>> {
+  CARBON_RETURN_IF_ERROR(interpreter_->RunAllSteps(
+      std::make_unique<ValueExpressionAction>(expression)));
+  return interpreter_->result();
+}
+
+void ExecutionReport::Print(llvm::raw_ostream& out) const {
+  out << "steps: " << steps << "\n"
+      << "max action depth: " << max_action_depth << "\n"
+      << "arena bytes: " << arena_bytes << "\n"
+      << "heap cells: " << heap_cells << "\n";
+}
+
 auto InterpProgram(const AST& ast, Nonnull<Arena*> arena,
+                   const ExecutionBudget& budget,
                    Nonnull<TraceStream*> trace_stream,
-                   Nonnull<llvm::raw_ostream*> print_stream) -> ErrorOr<int> {
-  Interpreter interpreter(Phase::RunTime, arena, trace_stream, print_stream);
+                   Nonnull<llvm::raw_ostream*> print_stream,
+                   Nonnull<ExecutionReport*> report) -> ErrorOr<int> {
+  IncrementalInterpreter interpreter(arena, budget, trace_stream,
+                                     print_stream);
+  auto store_report =
+      llvm::make_scope_exit([&] { *report = interpreter.usage(); });
   if (trace_stream->is_enabled()) {
     trace_stream->SubHeading("initializing globals");
   }
@@ -2605,8 +2887,7 @@ auto InterpProgram(const AST& ast, Nonnull<Arena*> arena,
                               ast.declarations.front()->source_loc());
   for (Nonnull<Declaration*> declaration : ast.declarations) {
     set_file_ctx.update_source_loc(declaration->source_loc());
-    CARBON_RETURN_IF_ERROR(interpreter.RunAllSteps(
-        std::make_unique<DeclarationAction>(declaration)));
+    CARBON_RETURN_IF_ERROR(interpreter.RunDeclaration(declaration));
   }
 
   if (trace_stream->is_enabled()) {
@@ -2615,18 +2896,17 @@ auto InterpProgram(const AST& ast, Nonnull<Arena*> arena,
 
   CARBON_CHECK(ast.main_call);
   set_file_ctx.update_source_loc(ast.main_call.value()->source_loc());
-  CARBON_RETURN_IF_ERROR(interpreter.RunAllSteps(
-      std::make_unique<ValueExpressionAction>(*ast.main_call)));
-
-  return cast<IntValue>(*interpreter.result()).value();
+  CARBON_ASSIGN_OR_RETURN(auto result,
+                          interpreter.RunExpression(*ast.main_call));
+  return cast<IntValue>(*result).value();
 }
 
 auto InterpExp(Nonnull<const Expression*> e, Nonnull<Arena*> arena,
                Nonnull<TraceStream*> trace_stream,
                Nonnull<llvm::raw_ostream*> print_stream)
     -> ErrorOr<Nonnull<const Value*>> {
-  Interpreter interpreter(Phase::CompileTime, arena, trace_stream,
-                          print_stream);
+  Interpreter interpreter(Phase::CompileTime, arena, ExecutionBudget(),
+                          trace_stream, print_stream);
   CARBON_RETURN_IF_ERROR(
       interpreter.RunAllSteps(std::make_unique<ValueExpressionAction>(e)));
   return interpreter.result();
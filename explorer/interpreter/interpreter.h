@@ -5,28 +5,104 @@
 #ifndef CARBON_EXPLORER_INTERPRETER_INTERPRETER_H_
 #define CARBON_EXPLORER_INTERPRETER_INTERPRETER_H_
 
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <vector>
+
 #include "common/ostream.h"
 #include "explorer/ast/ast.h"
+#include "explorer/ast/declaration.h"
 #include "explorer/ast/expression.h"
 #include "explorer/ast/value.h"
+#include "explorer/base/source_location.h"
 #include "explorer/base/trace_stream.h"
 
 namespace Carbon {
 
-// Interprets the program defined by `ast`, allocating values on `arena` and
-// printing traces if `trace` is true.
+class Interpreter;
+
+// Limits on the resources a run of the interpreter may use. Exceeding one is
+// reported as an error at the step that exceeds it, so a program that runs out
+// of budget fails the same way on every machine.
+struct ExecutionBudget {
+  // The number of steps taken, which catches infinite loops.
+  int64_t max_steps = 1e6;
+  // The number of actions on the stack, which catches unbounded recursion.
+  int64_t max_action_depth = 1e3;
+  // The number of bytes allocated in the arena, including those allocated
+  // before execution started.
+  int64_t max_arena_bytes = 1e9;
+  // The number of heap allocations, whether or not they've been freed.
+  int64_t max_heap_cells = std::numeric_limits<int64_t>::max();
+};
+
+// The resources used by a run of the interpreter, counted the same way as the
+// corresponding `ExecutionBudget` limits.
+struct ExecutionReport : public Printable<ExecutionReport> {
+  void Print(llvm::raw_ostream& out) const;
+
+  int64_t steps = 0;
+  // The largest number of actions that were on the stack at once.
+  int64_t max_action_depth = 0;
+  int64_t arena_bytes = 0;
+  int64_t heap_cells = 0;
+};
+
+// Executes a program incrementally, one fragment at a time. The heap and the
+// global variables of earlier fragments stay alive for later ones.
+class IncrementalInterpreter {
+ public:
+  IncrementalInterpreter(Nonnull<Arena*> arena, const ExecutionBudget& budget,
+                         Nonnull<TraceStream*> trace_stream,
+                         Nonnull<llvm::raw_ostream*> print_stream);
+  ~IncrementalInterpreter();
+
+  // Prepares to run the next fragment. This must be called after a failure
+  // before running anything else. Each fragment has the full budget for steps
+  // and action depth.
+  void StartFragment();
+
+  // Returns the resources used so far. Steps and action depth are counted
+  // since the last `StartFragment` call.
+  auto usage() const -> ExecutionReport;
+
+  // Runs `declaration`, initializing any global variable it declares.
+  auto RunDeclaration(Nonnull<Declaration*> declaration) -> ErrorOr<Success>;
+
+  // Evaluates `expression` and returns its value.
+  auto RunExpression(Nonnull<const Expression*> expression)
+      -> ErrorOr<Nonnull<const Value*>>;
+
+ private:
+  std::unique_ptr<Interpreter> interpreter_;
+};
+
+// Interprets the program defined by `ast` within `budget`, allocating values on
+// `arena` and printing traces if `trace` is true. The resources used are stored
+// in `report`, whether or not the program succeeds.
 auto InterpProgram(const AST& ast, Nonnull<Arena*> arena,
+                   const ExecutionBudget& budget,
                    Nonnull<TraceStream*> trace_stream,
-                   Nonnull<llvm::raw_ostream*> print_stream) -> ErrorOr<int>;
+                   Nonnull<llvm::raw_ostream*> print_stream,
+                   Nonnull<ExecutionReport*> report) -> ErrorOr<int>;
 
 // Interprets `e` at compile-time, allocating values on `arena` and
 // printing traces if `trace` is true. The caller must ensure that all the
-// code this evaluates has been typechecked.
+// code this evaluates has been typechecked. This uses the default
+// `ExecutionBudget`.
 auto InterpExp(Nonnull<const Expression*> e, Nonnull<Arena*> arena,
                Nonnull<TraceStream*> trace_stream,
                Nonnull<llvm::raw_ostream*> print_stream)
     -> ErrorOr<Nonnull<const Value*>>;
 
+// Validates a `Print` format string for `num_args` arguments, and splits it
+// into the segments to print. This only supports `{{` and `{N}` as special
+// syntax.
+auto ParsePrintFormat(SourceLocation source_loc, std::string_view format_string,
+                      int num_args) -> ErrorOr<std::vector<PrintFormatSegment>>;
+
 }  // namespace Carbon
 
 #endif  // CARBON_EXPLORER_INTERPRETER_INTERPRETER_H_
@@ -5,6 +5,7 @@
 #include "explorer/interpreter/resolve_control_flow.h"
 
 #include "explorer/ast/declaration.h"
+#include "explorer/ast/expression.h"
 #include "explorer/ast/return_term.h"
 #include "explorer/ast/statement.h"
 #include "explorer/base/error_builders.h"
@@ -74,6 +75,9 @@ static auto ResolveControlFlow(Nonnull<TraceStream*> trace_stream,
                  << " provide a return value, to match the function's "
                     "signature.";
         }
+        if (auto* call = llvm::dyn_cast<CallExpression>(&ret_exp.expression())) {
+          call->set_is_tail_call(true);
+        }
       }
 
       if (trace_stream->is_enabled()) {
@@ -235,12 +239,18 @@ auto ResolveControlFlow(Nonnull<TraceStream*> trace_stream,
   return Success();
 }
 
-auto ResolveControlFlow(Nonnull<TraceStream*> trace_stream, AST& ast)
+auto ResolveControlFlow(Nonnull<TraceStream*> trace_stream,
+                        llvm::ArrayRef<Nonnull<Declaration*>> declarations)
     -> ErrorOr<Success> {
-  for (auto* declaration : ast.declarations) {
+  for (auto* declaration : declarations) {
     CARBON_RETURN_IF_ERROR(ResolveControlFlow(trace_stream, declaration));
   }
   return Success();
 }
 
+auto ResolveControlFlow(Nonnull<TraceStream*> trace_stream, AST& ast)
+    -> ErrorOr<Success> {
+  return ResolveControlFlow(trace_stream, ast.declarations);
+}
+
 }  // namespace Carbon
@@ -8,6 +8,7 @@
 #include "explorer/ast/ast.h"
 #include "explorer/base/nonnull.h"
 #include "explorer/base/trace_stream.h"
+#include "llvm/ADT/ArrayRef.h"
 
 namespace Carbon {
 
@@ -18,6 +19,12 @@ namespace Carbon {
 auto ResolveControlFlow(Nonnull<TraceStream*> trace_stream, AST& ast)
     -> ErrorOr<Success>;
 
+// Equivalent to the above, but only processes `declarations`. Used when a
+// program is analyzed incrementally.
+auto ResolveControlFlow(Nonnull<TraceStream*> trace_stream,
+                        llvm::ArrayRef<Nonnull<Declaration*>> declarations)
+    -> ErrorOr<Success>;
+
 }  // namespace Carbon
 
 #endif  // CARBON_EXPLORER_INTERPRETER_RESOLVE_CONTROL_FLOW_H_
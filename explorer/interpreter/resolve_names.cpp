@@ -957,28 +957,66 @@ auto NameResolver::ResolveNamesImpl(Declaration& declaration,
   return Success();
 }
 
-auto ResolveNames(AST& ast, Nonnull<TraceStream*> trace_stream)
-    -> ErrorOr<Success> {
-  return RunWithExtraStack([&]() -> ErrorOr<Success> {
-    NameResolver resolver(trace_stream);
-    SetFileContext set_file_ctx(*trace_stream, std::nullopt);
-    StaticScope file_scope(trace_stream);
+class IncrementalNameResolver::Impl {
+ public:
+  explicit Impl(Nonnull<TraceStream*> trace_stream)
+      : trace_stream(trace_stream),
+        resolver(trace_stream),
+        file_scope(trace_stream) {}
+
+  Nonnull<TraceStream*> trace_stream;
+  NameResolver resolver;
+  StaticScope file_scope;
+  // The file scope as it was before the most recent fragment.
+  StaticScope checkpoint;
+};
 
-    for (auto* declaration : ast.declarations) {
+IncrementalNameResolver::IncrementalNameResolver(
+    Nonnull<TraceStream*> trace_stream)
+    : impl_(std::make_unique<Impl>(trace_stream)) {}
+
+IncrementalNameResolver::~IncrementalNameResolver() = default;
+
+auto IncrementalNameResolver::ResolveNames(
+    llvm::ArrayRef<Nonnull<Declaration*>> declarations,
+    std::optional<Nonnull<Expression*>> expression) -> ErrorOr<Success> {
+  impl_->checkpoint = impl_->file_scope;
+  ErrorOr<Success> result = RunWithExtraStack([&]() -> ErrorOr<Success> {
+    NameResolver& resolver = impl_->resolver;
+    StaticScope& file_scope = impl_->file_scope;
+    SetFileContext set_file_ctx(*impl_->trace_stream, std::nullopt);
+
+    for (auto* declaration : declarations) {
       set_file_ctx.update_source_loc(declaration->source_loc());
       CARBON_RETURN_IF_ERROR(resolver.AddExposedNames(
           *declaration, file_scope, /*allow_qualified_names=*/true));
     }
 
-    for (auto* declaration : ast.declarations) {
+    for (auto* declaration : declarations) {
       set_file_ctx.update_source_loc(declaration->source_loc());
       CARBON_RETURN_IF_ERROR(resolver.ResolveNames(
           *declaration, file_scope,
           NameResolver::ResolveFunctionBodies::AfterDeclarations));
     }
-    CARBON_RETURN_IF_ERROR(resolver.ResolveNames(**ast.main_call, file_scope));
+    if (expression) {
+      CARBON_RETURN_IF_ERROR(resolver.ResolveNames(**expression, file_scope));
+    }
     return Success();
   });
+  if (!result.ok()) {
+    Rollback();
+  }
+  return result;
+}
+
+void IncrementalNameResolver::Rollback() {
+  impl_->file_scope = impl_->checkpoint;
+}
+
+auto ResolveNames(AST& ast, Nonnull<TraceStream*> trace_stream)
+    -> ErrorOr<Success> {
+  return IncrementalNameResolver(trace_stream)
+      .ResolveNames(ast.declarations, *ast.main_call);
 }
 
 }  // namespace Carbon
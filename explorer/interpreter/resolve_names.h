@@ -5,9 +5,13 @@
 #ifndef CARBON_EXPLORER_INTERPRETER_RESOLVE_NAMES_H_
 #define CARBON_EXPLORER_INTERPRETER_RESOLVE_NAMES_H_
 
+#include <memory>
+#include <optional>
+
 #include "explorer/ast/ast.h"
 #include "explorer/base/arena.h"
 #include "explorer/base/trace_stream.h"
+#include "llvm/ADT/ArrayRef.h"
 
 namespace Carbon {
 
@@ -17,6 +21,29 @@ namespace Carbon {
 auto ResolveNames(AST& ast, Nonnull<TraceStream*> trace_stream)
     -> ErrorOr<Success>;
 
+// Resolves names in a program that's analyzed incrementally, one fragment at a
+// time. Names declared at file scope by earlier fragments are visible in later
+// ones.
+class IncrementalNameResolver {
+ public:
+  explicit IncrementalNameResolver(Nonnull<TraceStream*> trace_stream);
+  ~IncrementalNameResolver();
+
+  // Resolves names in the file-scope `declarations`, and then in `expression`.
+  // If this fails, the names declared by `declarations` are forgotten again.
+  auto ResolveNames(llvm::ArrayRef<Nonnull<Declaration*>> declarations,
+                    std::optional<Nonnull<Expression*>> expression)
+      -> ErrorOr<Success>;
+
+  // Forgets the names declared by the most recent call to `ResolveNames`. Used
+  // when a later phase rejects the fragment.
+  void Rollback();
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
 }  // namespace Carbon
 
 #endif  // CARBON_EXPLORER_INTERPRETER_RESOLVE_NAMES_H_
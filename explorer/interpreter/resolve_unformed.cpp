@@ -35,7 +35,7 @@ auto FlowFacts::action_type_string(ActionType action) const
 }
 
 auto FlowFacts::TakeAction(Nonnull<const AstNode*> node, ActionType action,
-                           SourceLocation source_loc, const std::string& name)
+                           SourceLocation source_loc, std::string_view name)
     -> ErrorOr<Success> {
   switch (action) {
     case ActionType::AddInit: {
@@ -460,12 +460,18 @@ static auto ResolveUnformed(Nonnull<TraceStream*> trace_stream,
   return Success();
 }
 
+auto ResolveUnformed(Nonnull<TraceStream*> trace_stream,
+                     llvm::ArrayRef<Nonnull<Declaration*>> declarations)
+    -> ErrorOr<Success> {
+  return ResolveUnformed(
+      trace_stream, llvm::ArrayRef<Nonnull<const Declaration*>>(declarations));
+}
+
 auto ResolveUnformed(Nonnull<TraceStream*> trace_stream, const AST& ast)
     -> ErrorOr<Success> {
-  for (auto* declaration : ast.declarations) {
-    CARBON_RETURN_IF_ERROR(ResolveUnformed(trace_stream, declaration));
-  }
-  return Success();
+  return ResolveUnformed(trace_stream,
+                         llvm::ArrayRef<Nonnull<const Declaration*>>(
+                             ast.declarations));
 }
 
 }  // namespace Carbon
@@ -11,6 +11,7 @@
 #include "explorer/ast/ast.h"
 #include "explorer/base/nonnull.h"
 #include "explorer/base/trace_stream.h"
+#include "llvm/ADT/ArrayRef.h"
 
 namespace Carbon {
 
@@ -41,7 +42,7 @@ class FlowFacts {
 
   // Take action on flow facts based on `ActionType`.
   auto TakeAction(Nonnull<const AstNode*> node, ActionType action,
-                  SourceLocation source_loc, const std::string& name)
+                  SourceLocation source_loc, std::string_view name)
       -> ErrorOr<Success>;
 
  private:
@@ -70,6 +71,12 @@ class FlowFacts {
 auto ResolveUnformed(Nonnull<TraceStream*> trace_stream, const AST& ast)
     -> ErrorOr<Success>;
 
+// Analyzes only the functions in `declarations`, for a program that's
+// analyzed one fragment at a time.
+auto ResolveUnformed(Nonnull<TraceStream*> trace_stream,
+                     llvm::ArrayRef<Nonnull<Declaration*>> declarations)
+    -> ErrorOr<Success>;
+
 }  // namespace Carbon
 
 #endif  // CARBON_EXPLORER_INTERPRETER_RESOLVE_UNFORMED_H_
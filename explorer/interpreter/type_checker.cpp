@@ -319,7 +319,7 @@ auto TypeChecker::FieldTypes(SourceLocation source_loc,
         CARBON_ASSIGN_OR_RETURN(
             Nonnull<const Value*> field_type,
             Substitute(class_type.bindings(), &var.binding().static_type()));
-        field_types.push_back({var.binding().name(), field_type});
+        field_types.push_back({std::string(var.binding().name()), field_type});
         break;
       }
       default:
@@ -634,7 +634,8 @@ auto TypeChecker::BuildBuiltinConversion(Nonnull<Expression*> source,
               return conversion_failed();
             }
             auto* elem = arena_->New<SimpleMemberAccessExpression>(
-                source->source_loc(), source, source_field->name);
+                source->source_loc(), source,
+                arena_->Intern(source_field->name));
             CARBON_RETURN_IF_ERROR(TypeCheckExp(elem, impl_scope));
             CARBON_ASSIGN_OR_RETURN(
                 Nonnull<Expression*> converted,
@@ -693,7 +694,7 @@ auto TypeChecker::BuildBuiltinConversion(Nonnull<Expression*> source,
             converted_elements.push_back(converted);
           }
           auto* result = arena_->New<TupleLiteral>(
-              source->source_loc(), std::move(converted_elements));
+              source->source_loc(), arena_->NewSpan(converted_elements));
           CARBON_RETURN_IF_ERROR(TypeCheckExp(result, impl_scope));
           return result;
         }
@@ -862,8 +863,8 @@ auto TypeChecker::ImplicitlyConvert(std::string_view context,
                               dest_elem));
         converted_elements.push_back(converted);
       }
-      auto* result = arena_->New<TupleLiteral>(source->source_loc(),
-                                               std::move(converted_elements));
+      auto* result = arena_->New<TupleLiteral>(
+          source->source_loc(), arena_->NewSpan(converted_elements));
       // TODO: Should be ExpressionCategory::Initializing.
       result->set_expression_category(ExpressionCategory::Value);
       result->set_static_type(destination);
@@ -970,12 +971,12 @@ auto TypeChecker::BuildBuiltinMethodCall(const ImplScope& impl_scope,
       arena_->New<ValueLiteral>(source_loc, iface_type, arena_->New<TypeType>(),
                                 ExpressionCategory::Value);
   Nonnull<Expression*> iface_member = arena_->New<SimpleMemberAccessExpression>(
-      source_loc, iface_expr, method.name);
+      source_loc, iface_expr, arena_->Intern(method.name));
   Nonnull<Expression*> method_access =
       arena_->New<CompoundMemberAccessExpression>(source_loc, source,
                                                   iface_member);
   Nonnull<Expression*> call_args =
-      arena_->New<TupleLiteral>(source_loc, method.arguments);
+      arena_->New<TupleLiteral>(source_loc, arena_->NewSpan(method.arguments));
   Nonnull<Expression*> call =
       arena_->New<CallExpression>(source_loc, method_access, call_args);
   CARBON_RETURN_IF_ERROR(TypeCheckExp(call, impl_scope));
@@ -3118,7 +3119,8 @@ auto TypeChecker::TypeCheckExpImpl(Nonnull<Expression*> e,
               if (!(*signature)->parameters_static_type()) {
                 access.set_member(
                     arena_->New<NamedElement>(arena_->New<NamedValue>(
-                        NamedValue{access.member_name(), &choice})));
+                        NamedValue{std::string(access.member_name()),
+                                   &choice})));
                 access.set_static_type(&choice);
                 access.set_expression_category(ExpressionCategory::Value);
                 return Success();
@@ -3134,7 +3136,7 @@ auto TypeChecker::TypeCheckExpImpl(Nonnull<Expression*> e,
               // choice type alternative?
               access.set_member(
                   arena_->New<NamedElement>(arena_->New<NamedValue>(
-                      NamedValue{access.member_name(), type})));
+                      NamedValue{std::string(access.member_name()), type})));
               access.set_static_type(type);
               access.set_expression_category(ExpressionCategory::Value);
               return Success();
@@ -3436,9 +3438,12 @@ auto TypeChecker::TypeCheckExpImpl(Nonnull<Expression*> e,
         return Success();
       };
 
-      auto handle_binary_arithmetic = [&](Builtin builtin) -> ErrorOr<Success> {
+      // Handles an operator that is built in for `i32` operands, and otherwise
+      // overloadable. The built-in form is evaluated directly by the
+      // interpreter rather than by calling the prelude's `impl`.
+      auto handle_binary_int_operator =
+          [&](Builtin builtin) -> ErrorOr<Success> {
         // Handle a built-in operator first.
-        // TODO: Replace this with an intrinsic.
         if (isa<IntType>(ts[0]) && isa<IntType>(ts[1]) &&
             IsSameType(ts[0], ts[1], impl_scope)) {
           op.set_static_type(ts[0]);
@@ -3453,6 +3458,17 @@ auto TypeChecker::TypeCheckExpImpl(Nonnull<Expression*> e,
       auto handle_compare =
           [&](Builtin builtin, const std::string& method_name,
               const std::string_view& operator_desc) -> ErrorOr<Success> {
+        // Handle a built-in comparison first: any comparison of `i32`s, and
+        // equality of `bool`s.
+        if (IsSameType(ts[0], ts[1], impl_scope) &&
+            (isa<IntType>(ts[0]) ||
+             (builtin == Builtin::EqWith && isa<BoolType>(ts[0])))) {
+          op.set_static_type(arena_->New<BoolType>());
+          op.set_expression_category(ExpressionCategory::Value);
+          return Success();
+        }
+
+        // Now try an overloaded comparison.
         ErrorOr<Nonnull<Expression*>> converted = BuildBuiltinMethodCall(
             impl_scope, op.arguments()[0], BuiltinInterfaceName{builtin, ts[1]},
             BuiltinMethodCall{method_name, op.arguments()[1]});
@@ -3469,7 +3485,6 @@ auto TypeChecker::TypeCheckExpImpl(Nonnull<Expression*> e,
       switch (op.op()) {
         case Operator::Neg: {
           // Handle a built-in negation first.
-          // TODO: Replace this with an intrinsic.
           if (isa<IntType>(ts[0])) {
             op.set_static_type(arena_->New<IntType>());
             op.set_expression_category(ExpressionCategory::Value);
@@ -3479,15 +3494,15 @@ auto TypeChecker::TypeCheckExpImpl(Nonnull<Expression*> e,
           return handle_unary_operator(Builtin::Negate);
         }
         case Operator::Add:
-          return handle_binary_arithmetic(Builtin::AddWith);
+          return handle_binary_int_operator(Builtin::AddWith);
         case Operator::Sub:
-          return handle_binary_arithmetic(Builtin::SubWith);
+          return handle_binary_int_operator(Builtin::SubWith);
         case Operator::Mul:
-          return handle_binary_arithmetic(Builtin::MulWith);
+          return handle_binary_int_operator(Builtin::MulWith);
         case Operator::Div:
-          return handle_binary_arithmetic(Builtin::DivWith);
+          return handle_binary_int_operator(Builtin::DivWith);
         case Operator::Mod:
-          return handle_binary_arithmetic(Builtin::ModWith);
+          return handle_binary_int_operator(Builtin::ModWith);
         case Operator::BitwiseAnd:
           // `&` between type-of-types performs constraint combination.
           // TODO: Should this be done via an intrinsic?
@@ -3513,16 +3528,23 @@ auto TypeChecker::TypeCheckExpImpl(Nonnull<Expression*> e,
                 ExpressionCategory::Value));
             return Success();
           }
-          return handle_binary_operator(Builtin::BitAndWith);
+          return handle_binary_int_operator(Builtin::BitAndWith);
         case Operator::BitwiseOr:
-          return handle_binary_operator(Builtin::BitOrWith);
+          return handle_binary_int_operator(Builtin::BitOrWith);
         case Operator::BitwiseXor:
-          return handle_binary_operator(Builtin::BitXorWith);
+          return handle_binary_int_operator(Builtin::BitXorWith);
         case Operator::BitShiftLeft:
-          return handle_binary_operator(Builtin::LeftShiftWith);
+          return handle_binary_int_operator(Builtin::LeftShiftWith);
         case Operator::BitShiftRight:
-          return handle_binary_operator(Builtin::RightShiftWith);
+          return handle_binary_int_operator(Builtin::RightShiftWith);
         case Operator::Complement:
+          // Handle a built-in complement first.
+          if (isa<IntType>(ts[0])) {
+            op.set_static_type(arena_->New<IntType>());
+            op.set_expression_category(ExpressionCategory::Value);
+            return Success();
+          }
+          // Now try an overloaded complement.
           return handle_unary_operator(Builtin::BitComplement);
         case Operator::And:
           CARBON_RETURN_IF_ERROR(ExpectExactType(e->source_loc(), "&&(1)",
@@ -3735,6 +3757,13 @@ auto TypeChecker::TypeCheckExpImpl(Nonnull<Expression*> e,
                 e->source_loc(), "Print argument 1", arena_->New<IntType>(),
                 &args[1]->static_type(), impl_scope));
           }
+          if (const auto* format_string = dyn_cast<StringLiteral>(args[0])) {
+            CARBON_ASSIGN_OR_RETURN(
+                std::vector<PrintFormatSegment> segments,
+                ParsePrintFormat(e->source_loc(), format_string->value(),
+                                 args.size() - 1));
+            intrinsic_exp.set_print_format(std::move(segments));
+          }
           e->set_static_type(TupleType::Empty());
           e->set_expression_category(ExpressionCategory::Value);
           return Success();
@@ -4808,6 +4837,12 @@ auto TypeChecker::TypeCheckStmt(Nonnull<Statement*> s,
             Nonnull<Expression*> converted_ret_val,
             ImplicitlyConvert("return value", impl_scope, &ret.expression(),
                               &return_term.static_type()));
+        if (converted_ret_val != &ret.expression()) {
+          // The conversion runs after the call, so it's not a tail call.
+          if (auto* call = dyn_cast<CallExpression>(&ret.expression())) {
+            call->set_is_tail_call(false);
+          }
+        }
         ret.set_expression(converted_ret_val);
       }
       return Success();
@@ -6152,6 +6187,13 @@ auto TypeChecker::DeclareAliasDeclaration(Nonnull<AliasDeclaration*> alias,
 
 auto TypeChecker::TypeCheck(AST& ast) -> ErrorOr<Success> {
   ImplScope impl_scope;
+  return TypeCheckFragment(ast.declarations, *ast.main_call, impl_scope);
+}
+
+auto TypeChecker::TypeCheckFragment(
+    llvm::ArrayRef<Nonnull<Declaration*>> declarations,
+    std::optional<Nonnull<Expression*>> expression, ImplScope& impl_scope)
+    -> ErrorOr<Success> {
   ScopeInfo top_level_scope_info = ScopeInfo::ForNonClassScope(&impl_scope);
   SetFileContext set_file_ctx(*trace_stream_, std::nullopt);
 
@@ -6159,7 +6201,7 @@ auto TypeChecker::TypeCheck(AST& ast) -> ErrorOr<Success> {
   llvm::SaveAndRestore<decltype(top_level_impl_scope_)>
       set_top_level_impl_scope(top_level_impl_scope_, &impl_scope);
 
-  for (auto declaration : ast.declarations) {
+  for (auto declaration : declarations) {
     set_file_ctx.update_source_loc(declaration->source_loc());
     CARBON_RETURN_IF_ERROR(
         DeclareDeclaration(declaration, top_level_scope_info));
@@ -6169,7 +6211,9 @@ auto TypeChecker::TypeCheck(AST& ast) -> ErrorOr<Success> {
     // TODO: Only do this when type-checking the prelude.
     builtins_.Register(declaration);
   }
-  CARBON_RETURN_IF_ERROR(TypeCheckExp(*ast.main_call, impl_scope));
+  if (expression) {
+    CARBON_RETURN_IF_ERROR(TypeCheckExp(*expression, impl_scope));
+  }
   return Success();
 }
 
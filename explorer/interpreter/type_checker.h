@@ -26,6 +26,7 @@
 #include "explorer/interpreter/interpreter.h"
 #include "explorer/interpreter/matching_impl_set.h"
 #include "explorer/interpreter/stack_space.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/identity.h"
 
 namespace Carbon {
@@ -66,6 +67,14 @@ class TypeChecker {
   // processed.
   auto TypeCheck(AST& ast) -> ErrorOr<Success>;
 
+  // Type-checks the file-scope `declarations` followed by `expression`, as one
+  // fragment of a program that's checked incrementally. `impl_scope` is the
+  // top-level `ImplScope` of the program; it holds the impls declared by
+  // earlier fragments, and impls declared by this one are added to it.
+  auto TypeCheckFragment(llvm::ArrayRef<Nonnull<Declaration*>> declarations,
+                         std::optional<Nonnull<Expression*>> expression,
+                         ImplScope& impl_scope) -> ErrorOr<Success>;
+
   // Construct a value that is the same as `value` except that occurrences
   // of generic parameters (aka. `GenericBinding` and references to
   // `ImplBinding`) are replaced by their corresponding value or witness in
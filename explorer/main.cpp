@@ -7,6 +7,7 @@
 #include <unistd.h>
 
 #include <chrono>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
@@ -15,10 +16,12 @@
 #include <vector>
 
 #include "common/error.h"
+#include "explorer/base/buffered_output_stream.h"
 #include "explorer/base/trace_stream.h"
 #include "explorer/parse_and_execute/parse_and_execute.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
@@ -30,6 +33,75 @@ namespace Carbon {
 namespace cl = llvm::cl;
 namespace path = llvm::sys::path;
 
+// Runs the fragments in `input_file_name`, or read from stdin if it's `-`, in
+// an `ExplorerSession`. Fragments are separated by blank lines. An error in a
+// fragment is reported, and the session continues with the next fragment. The
+// output of each fragment is flushed once it has run.
+static auto RunSession(llvm::vfs::FileSystem& fs,
+                       std::string_view prelude_file_name,
+                       llvm::StringRef input_file_name,
+                       Nonnull<TraceStream*> trace_stream,
+                       BufferedOutputStream& out_stream,
+                       llvm::raw_ostream& err_stream) -> int {
+  ErrorOr<std::unique_ptr<ExplorerSession>> session = ExplorerSession::Create(
+      fs, prelude_file_name, trace_stream, &out_stream);
+  out_stream.flush();
+  if (!session.ok()) {
+    err_stream << session.error() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  // Lines are read from stdin one at a time, so that each fragment runs as
+  // soon as it's complete.
+  std::unique_ptr<llvm::MemoryBuffer> input;
+  llvm::SmallVector<llvm::StringRef> input_lines;
+  if (input_file_name != "-") {
+    auto buffer = fs.getBufferForFile(input_file_name);
+    if (!buffer) {
+      err_stream << "Error opening `" << input_file_name
+                 << "`: " << buffer.getError().message() << "\n";
+      return EXIT_FAILURE;
+    }
+    input = std::move(*buffer);
+    input->getBuffer().split(input_lines, '\n');
+  }
+  size_t next_line = 0;
+  auto read_line = [&](std::string& line) -> bool {
+    if (!input) {
+      return static_cast<bool>(std::getline(std::cin, line));
+    }
+    if (next_line == input_lines.size()) {
+      return false;
+    }
+    line = input_lines[next_line++].str();
+    return true;
+  };
+
+  bool succeeded = true;
+  std::string fragment;
+  std::string line;
+  bool more_input = true;
+  while (more_input) {
+    more_input = read_line(line);
+    if (more_input && !llvm::StringRef(line).trim().empty()) {
+      fragment += line;
+      fragment += "\n";
+      continue;
+    }
+    if (fragment.empty()) {
+      continue;
+    }
+    auto result = (*session)->RunFragment(fragment);
+    fragment.clear();
+    out_stream.flush();
+    if (!result.ok()) {
+      err_stream << result.error() << "\n";
+      succeeded = false;
+    }
+  }
+  return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 auto ExplorerMain(int argc, char** argv, void* static_for_main_addr,
                   llvm::StringRef relative_prelude_path) -> int {
   llvm::setBugReportMsg(
@@ -60,6 +132,41 @@ auto ExplorerMain(int argc, const char** argv, llvm::StringRef install_path,
                                        cl::Required);
   cl::opt<bool> parser_debug("parser_debug",
                              cl::desc("Enable debug output from the parser"));
+  cl::opt<bool> session(
+      "session",
+      cl::desc("Run the input as a series of fragments, separated by blank "
+               "lines, each of which holds declarations or statements. Only "
+               "the new fragment is analyzed and executed each time. Set the "
+               "input file to `-` to read fragments from stdin."));
+  ExecutionBudget default_budget;
+  cl::opt<int64_t> max_steps(
+      "max_steps", cl::desc("The number of steps the program may execute."),
+      cl::init(default_budget.max_steps));
+  cl::opt<int64_t> max_action_depth(
+      "max_action_depth",
+      cl::desc("The number of actions that may be on the interpreter's stack, "
+               "which limits recursion."),
+      cl::init(default_budget.max_action_depth));
+  cl::opt<int64_t> max_arena_bytes(
+      "max_arena_bytes",
+      cl::desc("The number of bytes that may be allocated for the program, "
+               "including its AST."),
+      cl::init(default_budget.max_arena_bytes));
+  cl::opt<int64_t> max_heap_cells(
+      "max_heap_cells",
+      cl::desc("The number of heap allocations the program may make."),
+      cl::init(default_budget.max_heap_cells));
+  cl::opt<bool> print_usage(
+      "print_usage",
+      cl::desc("After running the program, print the resources it used to "
+               "stderr."));
+  cl::opt<size_t> print_buffer_size(
+      "print_buffer_size",
+      cl::desc("The number of bytes of program output to collect before "
+               "writing it out. Output is also written out when the program "
+               "finishes or fails. Set to 0 to write output immediately; this "
+               "is implied by `--trace_file=-`."),
+      cl::init(BufferedOutputStream::DefaultBufferSize));
   cl::opt<std::string> trace_file_name(
       "trace_file",
       cl::desc("Output file for tracing; set to `-` to output to stdout."));
@@ -175,9 +282,31 @@ auto ExplorerMain(int argc, const char** argv, llvm::StringRef install_path,
     }
   }
 
+  // Program output is buffered, unless trace output is interleaved with it.
+  BufferedOutputStream print_stream(
+      &out_stream, trace_file_name == "-" ? 0 : print_buffer_size.getValue());
+
+  if (session) {
+    return RunSession(fs, prelude_file_name, input_file_name, &trace_stream,
+                      print_stream, err_stream);
+  }
+
+  ExecutionBudget budget;
+  budget.max_steps = max_steps;
+  budget.max_action_depth = max_action_depth;
+  budget.max_arena_bytes = max_arena_bytes;
+  budget.max_heap_cells = max_heap_cells;
+  ExecutionReport report;
   ErrorOr<int> result =
       ParseAndExecute(fs, prelude_file_name, input_file_name, parser_debug,
-                      &trace_stream, &out_stream);
+                      budget, &trace_stream, &print_stream, &report);
+  print_stream.flush();
+  auto print_report = llvm::make_scope_exit([&] {
+    if (print_usage) {
+      err_stream << report << "printed bytes: " << print_stream.bytes_written()
+                 << "\n";
+    }
+  });
   if (result.ok()) {
     // Print the return code to stdout.
     out_stream << "result: " << *result << "\n";
@@ -13,6 +13,7 @@
 #include "explorer/syntax/parse.h"
 #include "explorer/syntax/prelude.h"
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/Support/FormatVariadic.h"
 
 namespace Carbon {
 
@@ -38,8 +39,10 @@ static auto PrintTimingOnExit(TraceStream* trace_stream, const char* label,
 
 auto ParseAndExecute(llvm::vfs::FileSystem& fs, std::string_view prelude_path,
                      std::string_view input_file_name, bool parser_debug,
+                     const ExecutionBudget& budget,
                      Nonnull<TraceStream*> trace_stream,
-                     Nonnull<llvm::raw_ostream*> print_stream) -> ErrorOr<int> {
+                     Nonnull<llvm::raw_ostream*> print_stream,
+                     Nonnull<ExecutionReport*> report) -> ErrorOr<int> {
   return RunWithExtraStack([&]() -> ErrorOr<int> {
     Arena arena;
     auto cursor = std::chrono::steady_clock::now();
@@ -66,8 +69,8 @@ auto ParseAndExecute(llvm::vfs::FileSystem& fs, std::string_view prelude_path,
     }
 
     // Run the program.
-    ErrorOr<int> exec_result =
-        ExecProgram(&arena, *analyze_result, trace_stream, print_stream);
+    ErrorOr<int> exec_result = ExecProgram(&arena, *analyze_result, budget,
+                                           trace_stream, print_stream, report);
     auto print_exec_time =
         PrintTimingOnExit(trace_stream, "ExecProgram", &cursor);
 
@@ -86,4 +89,113 @@ auto ParseAndExecute(llvm::vfs::FileSystem& fs, std::string_view prelude_path,
   });
 }
 
+auto ExplorerSession::Create(llvm::vfs::FileSystem& fs,
+                             std::string_view prelude_path,
+                             Nonnull<TraceStream*> trace_stream,
+                             Nonnull<llvm::raw_ostream*> print_stream)
+    -> ErrorOr<std::unique_ptr<ExplorerSession>> {
+  return RunWithExtraStack(
+      [&]() -> ErrorOr<std::unique_ptr<ExplorerSession>> {
+        std::unique_ptr<ExplorerSession> session(
+            new ExplorerSession(trace_stream, print_stream));
+        ErrorOr<AST> prelude = Parse(fs, &session->arena_, prelude_path,
+                                     FileKind::Prelude, /*parser_debug=*/false);
+        if (!prelude.ok()) {
+          return ErrorBuilder() << "SYNTAX ERROR: " << prelude.error();
+        }
+        prelude->num_prelude_declarations = prelude->declarations.size();
+        if (auto result = session->program_.AnalyzeFragment(*prelude);
+            !result.ok()) {
+          return ErrorBuilder() << "COMPILATION ERROR: " << result.error();
+        }
+        if (auto result = session->program_.ExecFragment(*prelude);
+            !result.ok()) {
+          return ErrorBuilder() << "RUNTIME ERROR: " << result.error();
+        }
+        return std::move(session);
+      });
+}
+
+auto ExplorerSession::ParseFragment(std::string_view source) -> ErrorOr<AST> {
+  // Each fragment is parsed as a file of its own. The package directive goes on
+  // the first line so that line numbers match the source.
+  ++num_fragments_;
+  std::string file_name = llvm::formatv("<fragment {0}>", num_fragments_);
+  std::string declarations =
+      llvm::formatv("package ExplorerSession api; {0}", source);
+  ErrorOr<AST> parse_result =
+      ParseFromString(&arena_, file_name, FileKind::Main, declarations,
+                      /*parser_debug=*/false);
+  if (parse_result.ok()) {
+    return parse_result;
+  }
+
+  // Not a list of declarations, so try it as statements in a function body.
+  std::string function_name = llvm::formatv("__Fragment{0}", num_fragments_);
+  std::string statements = llvm::formatv(
+      "package ExplorerSession api; fn {0}() {{ {1}\n}", function_name, source);
+  ErrorOr<AST> statements_result =
+      ParseFromString(&arena_, file_name, FileKind::Main, statements,
+                      /*parser_debug=*/false);
+  if (!statements_result.ok()) {
+    // Report the error from parsing declarations, since that's the first
+    // interpretation we tried.
+    return parse_result;
+  }
+  SourceLocation source_loc(statements_result->declarations.front()
+                                ->source_loc()
+                                .filename(),
+                            1, FileKind::Main);
+  statements_result->main_call = arena_.New<CallExpression>(
+      source_loc, arena_.New<IdentifierExpression>(source_loc,
+                                                arena_.Intern(function_name)),
+      arena_.New<TupleLiteral>(source_loc));
+  return statements_result;
+}
+
+auto ExplorerSession::RunFragment(std::string_view source)
+    -> ErrorOr<FragmentTiming> {
+  return RunWithExtraStack([&]() -> ErrorOr<FragmentTiming> {
+    FragmentTiming timing;
+    auto cursor = std::chrono::steady_clock::now();
+    auto lap = [&cursor]() {
+      auto end = std::chrono::steady_clock::now();
+      auto duration = end - cursor;
+      cursor = end;
+      return duration;
+    };
+
+    ErrorOr<AST> fragment = ParseFragment(source);
+    timing.parse = lap();
+    if (!fragment.ok()) {
+      return ErrorBuilder() << "SYNTAX ERROR: " << fragment.error();
+    }
+
+    ErrorOr<Success> analyze_result = program_.AnalyzeFragment(*fragment);
+    timing.analyze = lap();
+    if (!analyze_result.ok()) {
+      return ErrorBuilder() << "COMPILATION ERROR: " << analyze_result.error();
+    }
+
+    auto exec_result = program_.ExecFragment(*fragment);
+    timing.execute = lap();
+    if (!exec_result.ok()) {
+      return ErrorBuilder() << "RUNTIME ERROR: " << exec_result.error();
+    }
+
+    SetProgramPhase set_program_phase(*trace_stream_, ProgramPhase::Timing);
+    if (trace_stream_->is_enabled()) {
+      auto to_us = [](std::chrono::steady_clock::duration duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+            .count();
+      };
+      *trace_stream_ << "Time elapsed in fragment " << num_fragments_
+                     << ": parse " << to_us(timing.parse) << "us, analyze "
+                     << to_us(timing.analyze) << "us, execute "
+                     << to_us(timing.execute) << "us\n";
+    }
+    return timing;
+  });
+}
+
 }  // namespace Carbon
@@ -5,17 +5,70 @@
 #ifndef CARBON_EXPLORER_PARSE_AND_EXECUTE_PARSE_AND_EXECUTE_H_
 #define CARBON_EXPLORER_PARSE_AND_EXECUTE_PARSE_AND_EXECUTE_H_
 
+#include <chrono>
+#include <memory>
+#include <string_view>
+
 #include "common/error.h"
+#include "explorer/base/arena.h"
 #include "explorer/base/trace_stream.h"
+#include "explorer/interpreter/exec_program.h"
 #include "llvm/Support/VirtualFileSystem.h"
 
 namespace Carbon {
 
 // Parses and executes the input file, returning the program result on success.
+// Execution is limited to `budget`, and the resources it used are stored in
+// `report`, even if it fails. `report` is left unchanged if the program doesn't
+// get as far as executing.
 auto ParseAndExecute(llvm::vfs::FileSystem& fs, std::string_view prelude_path,
                      std::string_view input_file_name, bool parser_debug,
+                     const ExecutionBudget& budget,
+                     Nonnull<TraceStream*> trace_stream,
+                     Nonnull<llvm::raw_ostream*> print_stream,
+                     Nonnull<ExecutionReport*> report) -> ErrorOr<int>;
+
+// An interactive session, which runs a program one fragment at a time. The
+// prelude is loaded and analyzed once, when the session is created. After
+// that, each fragment is parsed, analyzed and executed in the context of the
+// fragments before it, without processing them again.
+class ExplorerSession {
+ public:
+  // The time spent on each phase of running a fragment.
+  struct FragmentTiming {
+    std::chrono::steady_clock::duration parse;
+    std::chrono::steady_clock::duration analyze;
+    std::chrono::steady_clock::duration execute;
+  };
+
+  // Creates a session with the prelude at `prelude_path` loaded.
+  static auto Create(llvm::vfs::FileSystem& fs, std::string_view prelude_path,
                      Nonnull<TraceStream*> trace_stream,
-                     Nonnull<llvm::raw_ostream*> print_stream) -> ErrorOr<int>;
+                     Nonnull<llvm::raw_ostream*> print_stream)
+      -> ErrorOr<std::unique_ptr<ExplorerSession>>;
+
+  // Runs `source`, which holds either declarations or statements. Declarations
+  // are added to the program, and global variables they declare keep their
+  // values for later fragments. Statements are run immediately, as the body of
+  // a function. The names declared by a fragment that fails aren't visible to
+  // later fragments.
+  auto RunFragment(std::string_view source) -> ErrorOr<FragmentTiming>;
+
+ private:
+  ExplorerSession(Nonnull<TraceStream*> trace_stream,
+                  Nonnull<llvm::raw_ostream*> print_stream)
+      : trace_stream_(trace_stream),
+        program_(&arena_, trace_stream, print_stream) {}
+
+  // Parses `source` as a fragment, synthesizing a function to hold it and a
+  // call to that function if it contains statements.
+  auto ParseFragment(std::string_view source) -> ErrorOr<AST>;
+
+  Arena arena_;
+  Nonnull<TraceStream*> trace_stream_;
+  IncrementalProgram program_;
+  int num_fragments_ = 0;
+};
 
 }  // namespace Carbon
 
@@ -7,11 +7,26 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "common/check.h"
+
 namespace Carbon {
 namespace {
 
+using ::testing::HasSubstr;
 using ::testing::MatchesRegex;
 
+// Returns a file system holding the prelude, as `prelude.carbon`.
+auto MakeFileSystemWithPrelude()
+    -> std::unique_ptr<llvm::vfs::InMemoryFileSystem> {
+  auto fs = std::make_unique<llvm::vfs::InMemoryFileSystem>();
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> prelude =
+      llvm::MemoryBuffer::getFile("explorer/data/prelude.carbon");
+  CARBON_CHECK(!prelude.getError()) << prelude.getError().message();
+  CARBON_CHECK(fs->addFile("prelude.carbon", /*ModificationTime=*/0,
+                           std::move(*prelude)));
+  return fs;
+}
+
 TEST(ParseAndExecuteTest, Recursion) {
   llvm::vfs::InMemoryFileSystem fs;
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> prelude =
@@ -42,9 +57,10 @@ TEST(ParseAndExecuteTest, Recursion) {
                          llvm::MemoryBuffer::getMemBuffer(source)));
 
   TraceStream trace_stream;
-  auto err =
-      ParseAndExecute(fs, "prelude.carbon", "test.carbon",
-                      /*parser_debug=*/false, &trace_stream, &llvm::nulls());
+  ExecutionReport report;
+  auto err = ParseAndExecute(fs, "prelude.carbon", "test.carbon",
+                             /*parser_debug=*/false, ExecutionBudget(),
+                             &trace_stream, &llvm::nulls(), &report);
   ASSERT_FALSE(err.ok());
   // Don't expect any particular source location for the error.
   EXPECT_THAT(err.error().message(),
@@ -52,5 +68,103 @@ TEST(ParseAndExecuteTest, Recursion) {
                            "interpreter actions on stack"));
 }
 
+TEST(ParseAndExecuteTest, Budget) {
+  auto fs = MakeFileSystemWithPrelude();
+  ASSERT_TRUE(fs->addFile("test.carbon", /*ModificationTime=*/0,
+                          llvm::MemoryBuffer::getMemBuffer(R"(
+    package Test api;
+    fn Main() -> i32 {
+      var count: i32 = 0;
+      while (true) {
+        count = count + 1;
+      }
+      return count;
+    }
+  )")));
+
+  TraceStream trace_stream;
+  ExecutionBudget budget;
+  budget.max_steps = 10000;
+  ExecutionReport report;
+  auto result = ParseAndExecute(*fs, "prelude.carbon", "test.carbon",
+                                /*parser_debug=*/false, budget, &trace_stream,
+                                &llvm::nulls(), &report);
+  ASSERT_FALSE(result.ok());
+  EXPECT_THAT(result.error().message(),
+              HasSubstr("possible infinite loop: too many interpreter steps "
+                        "executed"));
+  // The usage is reported even though the program failed.
+  EXPECT_EQ(report.steps, 10000);
+  EXPECT_GT(report.max_action_depth, 0);
+  EXPECT_GT(report.arena_bytes, 0);
+  EXPECT_GT(report.heap_cells, 0);
+}
+
+TEST(ParseAndExecuteTest, HeapCellBudget) {
+  auto fs = MakeFileSystemWithPrelude();
+  ASSERT_TRUE(fs->addFile("test.carbon", /*ModificationTime=*/0,
+                          llvm::MemoryBuffer::getMemBuffer(R"(
+    package Test api;
+    fn Main() -> i32 {
+      var count: i32 = 0;
+      while (count < 1000) {
+        heap.Delete(heap.New(count));
+        count = count + 1;
+      }
+      return count;
+    }
+  )")));
+
+  TraceStream trace_stream;
+  ExecutionBudget budget;
+  budget.max_heap_cells = 100;
+  ExecutionReport report;
+  auto result = ParseAndExecute(*fs, "prelude.carbon", "test.carbon",
+                                /*parser_debug=*/false, budget, &trace_stream,
+                                &llvm::nulls(), &report);
+  ASSERT_FALSE(result.ok());
+  // Cells count against the budget even once they've been deleted.
+  EXPECT_THAT(result.error().message(),
+              HasSubstr("out of memory: exceeded heap allocation limit"));
+  EXPECT_GT(report.heap_cells, 100);
+}
+
+TEST(ExplorerSessionTest, Fragments) {
+  auto fs = MakeFileSystemWithPrelude();
+  TraceStream trace_stream;
+  std::string output;
+  llvm::raw_string_ostream print_stream(output);
+  auto session = ExplorerSession::Create(*fs, "prelude.carbon", &trace_stream,
+                                         &print_stream);
+  ASSERT_TRUE(session.ok());
+
+  ASSERT_TRUE((*session)->RunFragment("var count: i32 = 1;").ok());
+  ASSERT_TRUE(
+      (*session)->RunFragment("fn Increment() { count = count + 1; }").ok());
+  ASSERT_TRUE((*session)
+                  ->RunFragment("Increment();\nPrint(\"{0}\", count);")
+                  .ok());
+  EXPECT_EQ(print_stream.str(), "2\n");
+}
+
+TEST(ExplorerSessionTest, FailedFragmentIsDiscarded) {
+  auto fs = MakeFileSystemWithPrelude();
+  TraceStream trace_stream;
+  std::string output;
+  llvm::raw_string_ostream print_stream(output);
+  auto session = ExplorerSession::Create(*fs, "prelude.carbon", &trace_stream,
+                                         &print_stream);
+  ASSERT_TRUE(session.ok());
+
+  auto result = (*session)->RunFragment("fn F() -> i32 { return G(); }");
+  ASSERT_FALSE(result.ok());
+  EXPECT_THAT(result.error().message(), HasSubstr("COMPILATION ERROR:"));
+
+  // `F` can be declared again, because the failed declaration was discarded.
+  ASSERT_TRUE((*session)->RunFragment("fn F() -> i32 { return 3; }").ok());
+  ASSERT_TRUE((*session)->RunFragment("Print(\"{0}\", F());").ok());
+  EXPECT_EQ(print_stream.str(), "3\n");
+}
+
 }  // namespace
 }  // namespace Carbon
@@ -12,10 +12,12 @@
 namespace Carbon::Check {
 
 auto CheckParseTree(const SemIR::File& builtin_ir,
+                    llvm::ArrayRef<const SemIR::File*> import_irs,
                     const Lex::TokenizedBuffer& tokens,
                     const Parse::Tree& parse_tree, DiagnosticConsumer& consumer,
                     llvm::raw_ostream* vlog_stream) -> SemIR::File {
-  auto semantics_ir = SemIR::File(tokens.filename().str(), &builtin_ir);
+  auto semantics_ir =
+      SemIR::File(tokens.filename().str(), &builtin_ir, import_irs);
 
   Parse::NodeLocationTranslator translator(&tokens, &parse_tree);
   ErrorTrackingDiagnosticConsumer err_tracker(consumer);
@@ -42,6 +44,8 @@ auto CheckParseTree(const SemIR::File& builtin_ir,
       CARBON_CHECK(err_tracker.seen_error())                                 \
           << "Handle" #Name " returned false without printing a diagnostic"; \
       semantics_ir.set_has_errors(true);                                     \
+      context.FinishImports();                                               \
+      semantics_ir.FreezeNameScopes();                                       \
       return semantics_ir;                                                   \
     }                                                                        \
     break;                                                                   \
@@ -50,10 +54,16 @@ auto CheckParseTree(const SemIR::File& builtin_ir,
     }
   }
 
-  // Pop information for the file-level scope.
+  // Pop information for the file-level scope, recording its names for files
+  // that import this one.
   semantics_ir.set_top_node_block_id(context.node_block_stack().Pop());
+  context.FinishImports();
+  context.ExportFileScope();
   context.PopScope();
 
+  // All declarations are complete, so name scopes won't change.
+  semantics_ir.FreezeNameScopes();
+
   context.VerifyOnFinish();
 
   semantics_ir.set_has_errors(err_tracker.seen_error());
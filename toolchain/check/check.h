@@ -6,6 +6,7 @@
 #define CARBON_TOOLCHAIN_CHECK_CHECK_H_
 
 #include "common/ostream.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "toolchain/diagnostics/diagnostic_emitter.h"
 #include "toolchain/lex/tokenized_buffer.h"
 #include "toolchain/parse/tree.h"
@@ -17,8 +18,11 @@ namespace Carbon::Check {
 // calls associated with a given compilation.
 inline auto MakeBuiltins() -> SemIR::File { return SemIR::File(); }
 
-// Produces and checks the IR for the provided Parse::Tree.
+// Produces and checks the IR for the provided Parse::Tree. Names that aren't
+// declared in the file are imported from the top-level declarations of
+// `import_irs` as they're used; those files must outlive the result.
 extern auto CheckParseTree(const SemIR::File& builtin_ir,
+                           llvm::ArrayRef<const SemIR::File*> import_irs,
                            const Lex::TokenizedBuffer& tokens,
                            const Parse::Tree& parse_tree,
                            DiagnosticConsumer& consumer,
@@ -4,6 +4,7 @@
 
 #include "toolchain/check/context.h"
 
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -105,6 +106,10 @@ auto Context::LookupName(Parse::Node parse_node, SemIR::StringId name_id,
   if (scope_id == SemIR::NameScopeId::Invalid) {
     auto it = name_lookup_.find(name_id);
     if (it == name_lookup_.end()) {
+      if (auto import_id = LookupImportedName(parse_node, name_id);
+          import_id.is_valid()) {
+        return import_id;
+      }
       if (print_diagnostics) {
         DiagnoseNameNotFound(parse_node, name_id);
       }
@@ -116,17 +121,151 @@ auto Context::LookupName(Parse::Node parse_node, SemIR::StringId name_id,
     // TODO: Check for ambiguous lookups.
     return it->second.back();
   } else {
-    const auto& scope = semantics_ir_->GetNameScope(scope_id);
-    auto it = scope.find(name_id);
-    if (it == scope.end()) {
+    auto node_id = semantics_ir_->LookupNameScopeEntry(scope_id, name_id);
+    if (!node_id.is_valid()) {
       if (print_diagnostics) {
         DiagnoseNameNotFound(parse_node, name_id);
       }
       return SemIR::NodeId::BuiltinError;
     }
 
+    return node_id;
+  }
+}
+
+auto Context::LookupImportedName(Parse::Node parse_node,
+                                 SemIR::StringId name_id) -> SemIR::NodeId {
+  if (auto it = imported_names_.find(name_id); it != imported_names_.end()) {
     return it->second;
   }
+
+  // Imported IRs have their own strings, so the name is found by its text.
+  // Builtins are the first IR, and don't declare names. Every imported IR is
+  // searched, so that a name declared by more than one of them is diagnosed
+  // rather than resolved by import order.
+  auto name = semantics_ir_->GetString(name_id);
+  std::optional<std::pair<SemIR::CrossReferenceIRId, SemIR::NodeId>> found;
+  for (int i : llvm::seq(1, semantics_ir_->cross_reference_irs_size())) {
+    SemIR::CrossReferenceIRId xref_id(i);
+    const auto& import_ir = semantics_ir_->GetCrossReferenceIR(xref_id);
+    if (!import_ir.file_scope_id().is_valid()) {
+      continue;
+    }
+    auto import_name_id = import_ir.LookupString(name);
+    if (!import_name_id) {
+      continue;
+    }
+    auto import_node_id = import_ir.LookupNameScopeEntry(
+        import_ir.file_scope_id(), *import_name_id);
+    if (!import_node_id.is_valid()) {
+      continue;
+    }
+    if (found) {
+      CARBON_DIAGNOSTIC(
+          NameImportAmbiguous, Error,
+          "Name `{0}` is declared by more than one imported file: `{1}` and "
+          "`{2}`.",
+          llvm::StringRef, std::string, std::string);
+      emitter_->Emit(
+          parse_node, NameImportAmbiguous, name,
+          semantics_ir_->GetCrossReferenceIR(found->first).filename().str(),
+          import_ir.filename().str());
+      imported_names_.insert({name_id, SemIR::NodeId::BuiltinError});
+      return SemIR::NodeId::BuiltinError;
+    }
+    found = {xref_id, import_node_id};
+  }
+
+  auto result_id = SemIR::NodeId::Invalid;
+  if (found) {
+    result_id = ImportDeclaration(parse_node, found->first, found->second);
+  }
+  imported_names_.insert({name_id, result_id});
+  return result_id;
+}
+
+auto Context::ImportDeclaration(Parse::Node parse_node,
+                                SemIR::CrossReferenceIRId xref_id,
+                                SemIR::NodeId import_node_id)
+    -> SemIR::NodeId {
+  const auto& import_ir = semantics_ir_->GetCrossReferenceIR(xref_id);
+  auto import_node = import_ir.GetNode(import_node_id);
+  switch (import_node.kind()) {
+    case SemIR::NodeKind::FunctionDeclaration: {
+      // Calls need a function in this file, so the signature is rebuilt here.
+      // The body stays in the imported IR, and is found when linking. As with
+      // declarations in this file, the parameters aren't in any block.
+      const auto& import_function =
+          import_ir.GetFunction(import_node.GetAsFunctionDeclaration());
+      if (!import_function.name_id.is_valid()) {
+        return SemIR::NodeId::Invalid;
+      }
+      llvm::SmallVector<SemIR::NodeId> param_ids;
+      for (auto import_param_id :
+           import_ir.GetNodeBlock(import_function.param_refs_id)) {
+        auto import_param = import_ir.GetNode(import_param_id);
+        auto param_type_id =
+            ImportType(parse_node, xref_id, import_param.type_id());
+        param_ids.push_back(
+            semantics_ir_->AddNodeInNoBlock(SemIR::Node::Parameter::Make(
+                parse_node, param_type_id,
+                semantics_ir_->AddString(
+                    import_ir.GetString(import_param.GetAsParameter())))));
+      }
+      auto return_type_id = SemIR::TypeId::Invalid;
+      auto return_slot_id = SemIR::NodeId::Invalid;
+      if (import_function.return_type_id.is_valid()) {
+        return_type_id =
+            ImportType(parse_node, xref_id, import_function.return_type_id);
+        if (import_function.return_slot_id.is_valid()) {
+          return_slot_id =
+              semantics_ir_->AddNodeInNoBlock(SemIR::Node::VarStorage::Make(
+                  parse_node, return_type_id,
+                  semantics_ir_->AddString("return")));
+        }
+      }
+      auto function_id = semantics_ir_->AddFunction(
+          {.name_id = semantics_ir_->AddString(
+               import_ir.GetString(import_function.name_id)),
+           .param_refs_id = semantics_ir_->AddNodeBlock(param_ids),
+           .return_type_id = return_type_id,
+           .return_slot_id = return_slot_id,
+           .body_block_ids = {}});
+      return AddImportNode(
+          SemIR::Node::FunctionDeclaration::Make(parse_node, function_id));
+    }
+
+    case SemIR::NodeKind::Namespace:
+      // TODO: Import namespaces, which requires importing their name scopes.
+      return SemIR::NodeId::Invalid;
+
+    default: {
+      if (import_node.kind().value_kind() != SemIR::NodeValueKind::Typed) {
+        return SemIR::NodeId::Invalid;
+      }
+      return AddImportNode(SemIR::Node::CrossReference::Make(
+          ImportType(parse_node, xref_id, import_node.type_id()), xref_id,
+          import_node_id));
+    }
+  }
+}
+
+auto Context::FinishImports() -> void {
+  if (!import_node_ids_.empty()) {
+    semantics_ir_->set_imports_block_id(
+        semantics_ir_->AddNodeBlock(import_node_ids_));
+  }
+}
+
+auto Context::ExportFileScope() -> void {
+  CARBON_CHECK(scope_stack_.size() == 1)
+      << "Exporting from a non-file scope: " << scope_stack_.size();
+  auto scope_id = semantics_ir_->AddNameScope();
+  for (auto name_id : current_scope().names) {
+    semantics_ir_->AddNameScopeEntry(scope_id, name_id,
+                                     name_lookup_[name_id].back());
+  }
+  semantics_ir_->set_file_scope_id(scope_id);
 }
 
 auto Context::PushScope() -> void { scope_stack_.push_back({}); }
@@ -407,6 +546,107 @@ auto Context::CanonicalizeType(SemIR::NodeId node_id) -> SemIR::TypeId {
   return CanonicalizeTypeImpl(node.kind(), profile_node, make_node);
 }
 
+auto Context::CanonicalizeImportedType(SemIR::Node node) -> SemIR::TypeId {
+  auto profile_node = [&](llvm::FoldingSetNodeID& canonical_id) {
+    ProfileType(*this, node, canonical_id);
+  };
+  auto make_node = [&] { return AddImportNode(node); };
+  return CanonicalizeTypeImpl(node.kind(), profile_node, make_node);
+}
+
+auto Context::ImportType(Parse::Node parse_node,
+                         SemIR::CrossReferenceIRId xref_id,
+                         SemIR::TypeId type_id) -> SemIR::TypeId {
+  // Invalid, TypeType, and Error have negative indices, and mean the same thing
+  // in every IR.
+  if (type_id.index < 0) {
+    return type_id;
+  }
+  std::pair<int32_t, int32_t> key = {xref_id.index, type_id.index};
+  if (auto it = imported_types_.find(key); it != imported_types_.end()) {
+    return it->second;
+  }
+
+  const auto& import_ir = semantics_ir_->GetCrossReferenceIR(xref_id);
+  auto import_node_id = import_ir.GetType(type_id);
+  auto result_id = SemIR::TypeId::Invalid;
+  if (import_node_id.index < SemIR::BuiltinKind::ValidCount) {
+    // Builtins are at the same node IDs in every IR.
+    result_id = CanonicalizeType(import_node_id);
+  } else {
+    // Types are structural, so they're rebuilt from their imported components.
+    // This can't happen inside `make_node`, which isn't allowed to
+    // canonicalize types.
+    auto import_node = import_ir.GetNode(import_node_id);
+    switch (import_node.kind()) {
+      case SemIR::NodeKind::ArrayType: {
+        auto [import_bound_id, import_element_type_id] =
+            import_node.GetAsArrayType();
+        auto element_type_id =
+            ImportType(parse_node, xref_id, import_element_type_id);
+        auto import_bound = import_ir.GetNode(import_bound_id);
+        auto bound_id = AddImportNode(SemIR::Node::IntegerLiteral::Make(
+            parse_node, ImportType(parse_node, xref_id, import_bound.type_id()),
+            semantics_ir_->AddIntegerLiteral(import_ir.GetIntegerLiteral(
+                import_bound.GetAsIntegerLiteral()))));
+        result_id = CanonicalizeImportedType(SemIR::Node::ArrayType::Make(
+            parse_node, SemIR::TypeId::TypeType, bound_id, element_type_id));
+        break;
+      }
+      case SemIR::NodeKind::ConstType: {
+        auto inner_id =
+            ImportType(parse_node, xref_id, import_node.GetAsConstType());
+        result_id = CanonicalizeImportedType(SemIR::Node::ConstType::Make(
+            parse_node, SemIR::TypeId::TypeType, inner_id));
+        break;
+      }
+      case SemIR::NodeKind::PointerType: {
+        auto pointee_id =
+            ImportType(parse_node, xref_id, import_node.GetAsPointerType());
+        result_id = CanonicalizeImportedType(SemIR::Node::PointerType::Make(
+            parse_node, SemIR::TypeId::TypeType, pointee_id));
+        break;
+      }
+      case SemIR::NodeKind::StructType: {
+        llvm::SmallVector<SemIR::NodeId> field_ids;
+        for (auto import_field_id :
+             import_ir.GetNodeBlock(import_node.GetAsStructType())) {
+          auto [import_name_id, import_field_type_id] =
+              import_ir.GetNode(import_field_id).GetAsStructTypeField();
+          auto field_type_id =
+              ImportType(parse_node, xref_id, import_field_type_id);
+          field_ids.push_back(
+              AddImportNode(SemIR::Node::StructTypeField::Make(
+                  parse_node,
+                  semantics_ir_->AddString(import_ir.GetString(import_name_id)),
+                  field_type_id)));
+        }
+        result_id = CanonicalizeImportedType(SemIR::Node::StructType::Make(
+            parse_node, SemIR::TypeId::TypeType,
+            semantics_ir_->AddNodeBlock(field_ids)));
+        break;
+      }
+      case SemIR::NodeKind::TupleType: {
+        llvm::SmallVector<SemIR::TypeId> element_type_ids;
+        for (auto import_element_type_id :
+             import_ir.GetTypeBlock(import_node.GetAsTupleType())) {
+          element_type_ids.push_back(
+              ImportType(parse_node, xref_id, import_element_type_id));
+        }
+        result_id = CanonicalizeImportedType(SemIR::Node::TupleType::Make(
+            parse_node, SemIR::TypeId::TypeType,
+            semantics_ir_->AddTypeBlock(element_type_ids)));
+        break;
+      }
+      default:
+        CARBON_FATAL() << "Unexpected imported type node " << import_node;
+    }
+  }
+
+  imported_types_.insert({key, result_id});
+  return result_id;
+}
+
 auto Context::CanonicalizeStructType(Parse::Node parse_node,
                                      SemIR::NodeBlockId refs_id)
     -> SemIR::TypeId {
@@ -50,6 +50,28 @@ class Context {
                   SemIR::NameScopeId scope_id, bool print_diagnostics)
       -> SemIR::NodeId;
 
+  // Looks up a name that isn't declared in this file among the top-level
+  // declarations of the imported IRs. The first lookup of a name materializes
+  // its declaration in this file, and later lookups reuse it, so only names
+  // that are used are imported. Returns an invalid ID if no imported IR
+  // declares the name, and diagnoses and returns `BuiltinError` if more than
+  // one does.
+  auto LookupImportedName(Parse::Node parse_node, SemIR::StringId name_id)
+      -> SemIR::NodeId;
+
+  // Returns the type in this file corresponding to `type_id` in the given
+  // imported IR, building it on first use.
+  auto ImportType(Parse::Node parse_node, SemIR::CrossReferenceIRId xref_id,
+                  SemIR::TypeId type_id) -> SemIR::TypeId;
+
+  // Adds the nodes materialized for imported declarations to the imports block
+  // of the file.
+  auto FinishImports() -> void;
+
+  // Records the names in the current scope, which must be the file scope, as
+  // the name scope that other files import from.
+  auto ExportFileScope() -> void;
+
   // Prints a diagnostic for a duplicate name.
   auto DiagnoseDuplicateName(Parse::Node parse_node, SemIR::NodeId prev_def_id)
       -> void;
@@ -234,6 +256,23 @@ class Context {
   // the current block.
   auto CanonicalizeTypeAndAddNodeIfNew(SemIR::Node node) -> SemIR::TypeId;
 
+  // Forms a canonical type ID for a type. If the type is new, adds the node to
+  // the imports block.
+  auto CanonicalizeImportedType(SemIR::Node node) -> SemIR::TypeId;
+
+  // Materializes a top-level declaration of an imported IR in this file.
+  // Returns an invalid ID if the declaration can't be imported.
+  auto ImportDeclaration(Parse::Node parse_node,
+                         SemIR::CrossReferenceIRId xref_id,
+                         SemIR::NodeId import_node_id) -> SemIR::NodeId;
+
+  // Adds a node for an import, which isn't part of any other block.
+  auto AddImportNode(SemIR::Node node) -> SemIR::NodeId {
+    auto node_id = semantics_ir_->AddNodeInNoBlock(node);
+    import_node_ids_.push_back(node_id);
+    return node_id;
+  }
+
   auto current_scope() -> ScopeStackEntry& { return scope_stack_.back(); }
 
   // Tokens for getting data on literals.
@@ -298,6 +337,17 @@ class Context {
   // Storage for the nodes in canonical_type_nodes_. This stores in pointers so
   // that FoldingSet can have stable pointers.
   llvm::SmallVector<std::unique_ptr<TypeNode>> type_node_storage_;
+
+  // Results of LookupImportedName, including names that weren't found, so each
+  // name is only looked up in the imported IRs once.
+  llvm::DenseMap<SemIR::StringId, SemIR::NodeId> imported_names_;
+
+  // Types built by ImportType, keyed by the index of the imported IR and the
+  // type's index within it.
+  llvm::DenseMap<std::pair<int32_t, int32_t>, SemIR::TypeId> imported_types_;
+
+  // Nodes materialized for imports, which form the file's imports block.
+  llvm::SmallVector<SemIR::NodeId> import_node_ids_;
 };
 
 // Parse node handlers. Returns false for unrecoverable errors.
@@ -6,24 +6,43 @@
 
 namespace Carbon::Check {
 
-auto HandlePackageApi(Context& context, Parse::Node parse_node) -> bool {
-  return context.TODO(parse_node, "HandlePackageApi");
+// The driver uses `package` directives to find the files that a file imports
+// from, so checking only needs to consume them.
+// TODO: Record the package and library in the SemIR.
+
+auto HandlePackageApi(Context& /*context*/, Parse::Node /*parse_node*/)
+    -> bool {
+  return true;
 }
 
-auto HandlePackageDirective(Context& context, Parse::Node parse_node) -> bool {
-  return context.TODO(parse_node, "HandlePackageDirective");
+auto HandlePackageDirective(Context& context, Parse::Node /*parse_node*/)
+    -> bool {
+  // After a parse error, the name or library may be missing, so discard
+  // whatever was pushed for the directive.
+  while (context.parse_tree().node_kind(
+             context.node_stack().PeekParseNode()) !=
+         Parse::NodeKind::PackageIntroducer) {
+    context.node_stack().PopAndIgnore();
+  }
+  context.node_stack()
+      .PopAndDiscardSoloParseNode<Parse::NodeKind::PackageIntroducer>();
+  return true;
 }
 
-auto HandlePackageImpl(Context& context, Parse::Node parse_node) -> bool {
-  return context.TODO(parse_node, "HandlePackageImpl");
+auto HandlePackageImpl(Context& /*context*/, Parse::Node /*parse_node*/)
+    -> bool {
+  return true;
 }
 
-auto HandlePackageIntroducer(Context& context, Parse::Node parse_node) -> bool {
-  return context.TODO(parse_node, "HandlePackageIntroducer");
+auto HandlePackageIntroducer(Context& context, Parse::Node parse_node)
+    -> bool {
+  context.node_stack().Push(parse_node);
+  return true;
 }
 
-auto HandlePackageLibrary(Context& context, Parse::Node parse_node) -> bool {
-  return context.TODO(parse_node, "HandlePackageLibrary");
+auto HandlePackageLibrary(Context& /*context*/, Parse::Node /*parse_node*/)
+    -> bool {
+  return true;
 }
 
 }  // namespace Carbon::Check
@@ -6,17 +6,22 @@
 
 #include <memory>
 
+#include "llvm/Analysis/ModuleSummaryAnalysis.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/MC/TargetRegistry.h"
+#include "llvm/Passes/PassBuilder.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/TargetParser/Host.h"
+#include "llvm/Transforms/Instrumentation/InstrProfiling.h"
 
 namespace Carbon {
 
-auto CodeGen::Create(llvm::Module& module, llvm::StringRef target_triple,
-                     llvm::raw_pwrite_stream& errors)
-    -> std::optional<CodeGen> {
+// Returns the LLVM target for `target_triple`, or null after printing an error
+// if it's invalid.
+static auto LookupTarget(llvm::StringRef target_triple,
+                         llvm::raw_ostream& errors) -> const llvm::Target* {
   // Initialize the target registry etc.
   llvm::InitializeAllTargetInfos();
   llvm::InitializeAllTargets();
@@ -30,21 +35,47 @@ auto CodeGen::Create(llvm::Module& module, llvm::StringRef target_triple,
 
   if (!target) {
     errors << "ERROR: Invalid target: " << error << "\n";
-    return {};
   }
-  module.setTargetTriple(target_triple);
+  return target;
+}
 
+// Creates a machine for `target` with the default CPU and features.
+static auto CreateTargetMachine(const llvm::Target& target,
+                                llvm::StringRef target_triple)
+    -> std::unique_ptr<llvm::TargetMachine> {
   constexpr llvm::StringLiteral CPU = "generic";
   constexpr llvm::StringLiteral Features = "";
 
   llvm::TargetOptions target_opts;
   std::optional<llvm::Reloc::Model> reloc_model;
-  CodeGen codegen(module, errors);
-  codegen.target_machine_.reset(target->createTargetMachine(
+  return std::unique_ptr<llvm::TargetMachine>(target.createTargetMachine(
       target_triple, CPU, Features, target_opts, reloc_model));
+}
+
+auto CodeGen::Create(llvm::Module& module, llvm::StringRef target_triple,
+                     llvm::raw_pwrite_stream& errors)
+    -> std::optional<CodeGen> {
+  const llvm::Target* target = LookupTarget(target_triple, errors);
+  if (!target) {
+    return {};
+  }
+  module.setTargetTriple(target_triple);
+
+  CodeGen codegen(module, errors);
+  codegen.target_machine_ = CreateTargetMachine(*target, target_triple);
   return codegen;
 }
 
+auto CodeGen::GetDataLayout(llvm::StringRef target_triple,
+                            llvm::raw_ostream& errors)
+    -> std::optional<llvm::DataLayout> {
+  const llvm::Target* target = LookupTarget(target_triple, errors);
+  if (!target) {
+    return std::nullopt;
+  }
+  return CreateTargetMachine(*target, target_triple)->createDataLayout();
+}
+
 auto CodeGen::EmitAssembly(llvm::raw_pwrite_stream& out) -> bool {
   return EmitCode(out, llvm::CodeGenFileType::AssemblyFile);
 }
@@ -53,9 +84,49 @@ auto CodeGen::EmitObject(llvm::raw_pwrite_stream& out) -> bool {
   return EmitCode(out, llvm::CodeGenFileType::ObjectFile);
 }
 
+auto CodeGen::PrepareModule() -> void {
+  module_.setDataLayout(target_machine_->createDataLayout());
+
+  // Profile instrumentation is emitted as intrinsics during lowering. Replace
+  // them with the counters and runtime registration they stand for.
+  if (!module_.getFunction("llvm.instrprof.increment") &&
+      !module_.getFunction("llvm.instrprof.increment.step")) {
+    return;
+  }
+  llvm::LoopAnalysisManager loop_analyses;
+  llvm::FunctionAnalysisManager function_analyses;
+  llvm::CGSCCAnalysisManager cgscc_analyses;
+  llvm::ModuleAnalysisManager module_analyses;
+  llvm::PassBuilder pass_builder(target_machine_.get());
+  pass_builder.registerModuleAnalyses(module_analyses);
+  pass_builder.registerCGSCCAnalyses(cgscc_analyses);
+  pass_builder.registerFunctionAnalyses(function_analyses);
+  pass_builder.registerLoopAnalyses(loop_analyses);
+  pass_builder.crossRegisterProxies(loop_analyses, function_analyses,
+                                    cgscc_analyses, module_analyses);
+
+  llvm::ModulePassManager passes;
+  passes.addPass(llvm::InstrProfiling());
+  passes.run(module_, module_analyses);
+}
+
+auto CodeGen::EmitBitcode(llvm::raw_pwrite_stream& out, bool thin_lto_summary)
+    -> void {
+  PrepareModule();
+
+  if (thin_lto_summary) {
+    llvm::ModuleSummaryIndex index = llvm::buildModuleSummaryIndex(
+        module_, /*GetBFICallback=*/nullptr, /*PSI=*/nullptr);
+    llvm::WriteBitcodeToFile(module_, out,
+                             /*ShouldPreserveUseListOrder=*/false, &index);
+  } else {
+    llvm::WriteBitcodeToFile(module_, out);
+  }
+}
+
 auto CodeGen::EmitCode(llvm::raw_pwrite_stream& out,
                        llvm::CodeGenFileType file_type) -> bool {
-  module_.setDataLayout(target_machine_->createDataLayout());
+  PrepareModule();
 
   // Using the legacy PM to generate the assembly since the new PM
   // does not work with this yet.
@@ -5,6 +5,7 @@
 #ifndef CARBON_TOOLCHAIN_CODEGEN_CODEGEN_H_
 #define CARBON_TOOLCHAIN_CODEGEN_CODEGEN_H_
 
+#include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Target/TargetMachine.h"
 
@@ -15,6 +16,13 @@ class CodeGen {
   static auto Create(llvm::Module& module, llvm::StringRef target_triple,
                      llvm::raw_pwrite_stream& errors) -> std::optional<CodeGen>;
 
+  // Returns the data layout that codegen uses for `target_triple`, so that it
+  // can be set on a module before lowering. Returns nullopt if the target is
+  // invalid, and prints the error to the error stream.
+  static auto GetDataLayout(llvm::StringRef target_triple,
+                            llvm::raw_ostream& errors)
+      -> std::optional<llvm::DataLayout>;
+
   // Generates the object code file.
   // Returns false in case of failure, and any information about the failure is
   // printed to the error stream.
@@ -31,10 +39,20 @@ class CodeGen {
   // patching the output.
   auto EmitAssembly(llvm::raw_pwrite_stream& out) -> bool;
 
+  // Writes the module as LLVM bitcode, for later link-time optimization. When
+  // `thin_lto_summary` is set, the bitcode includes a module summary index so
+  // that it can be used for ThinLTO; otherwise, it's used for full LTO.
+  auto EmitBitcode(llvm::raw_pwrite_stream& out, bool thin_lto_summary)
+      -> void;
+
  private:
   explicit CodeGen(llvm::Module& module, llvm::raw_pwrite_stream& errors)
       : module_(module), errors_(errors) {}
 
+  // Sets the module's data layout for the target, and lowers any profile
+  // instrumentation in it.
+  auto PrepareModule() -> void;
+
   // Using the llvm pass emits either assembly or object code to dest.
   // Returns false in case of failure, and any information about the failure is
   // printed to the error stream.
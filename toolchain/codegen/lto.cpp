@@ -0,0 +1,121 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/codegen/lto.h"
+
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/LTO/LTO.h"
+#include "llvm/Support/Caching.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
+
+namespace Carbon {
+
+auto RunLinkTimeOptimization(
+    llvm::ArrayRef<std::unique_ptr<llvm::MemoryBuffer>> inputs,
+    const LinkTimeOptimizationOptions& options, llvm::raw_ostream& errors)
+    -> bool {
+  // Initialize the target registry etc.
+  llvm::InitializeAllTargetInfos();
+  llvm::InitializeAllTargets();
+  llvm::InitializeAllTargetMCs();
+  llvm::InitializeAllAsmParsers();
+  llvm::InitializeAllAsmPrinters();
+
+  llvm::ThreadPoolStrategy parallelism =
+      llvm::heavyweight_hardware_concurrency(options.jobs);
+
+  llvm::lto::Config config;
+  config.DefaultTriple = options.target_triple.str();
+  config.CPU = "generic";
+
+  llvm::lto::LTO lto(std::move(config),
+                     llvm::lto::createInProcessThinBackend(parallelism),
+                     /*ParallelCodeGenParallelismLevel=*/
+                     parallelism.compute_thread_count());
+
+  llvm::StringSet<> preserved_symbols;
+  preserved_symbols.insert("main");
+  for (auto symbol : options.preserved_symbols) {
+    preserved_symbols.insert(symbol);
+  }
+
+  // Resolve symbols the way a linker would: the first definition of each symbol
+  // prevails, and only preserved symbols are visible outside of LTO. Only weak
+  // symbols may be defined by more than one file; the input file that first
+  // strongly defined each symbol is tracked to diagnose duplicates.
+  llvm::StringSet<> defined_symbols;
+  llvm::StringMap<llvm::StringRef> strong_definitions;
+  for (const auto& input : inputs) {
+    auto input_file =
+        llvm::lto::InputFile::create(input->getMemBufferRef());
+    if (!input_file) {
+      errors << "ERROR: Unable to read bitcode file '"
+             << input->getBufferIdentifier()
+             << "': " << llvm::toString(input_file.takeError()) << "\n";
+      return false;
+    }
+
+    std::vector<llvm::lto::SymbolResolution> resolutions;
+    for (const auto& symbol : (*input_file)->symbols()) {
+      if (!symbol.isUndefined() && !symbol.isWeak() && !symbol.isCommon()) {
+        auto [it, inserted] = strong_definitions.insert(
+            {symbol.getName(), input->getBufferIdentifier()});
+        if (!inserted) {
+          errors << "ERROR: Duplicate definition of symbol '"
+                 << symbol.getName() << "' in '"
+                 << input->getBufferIdentifier() << "', first defined in '"
+                 << it->second << "'\n";
+          return false;
+        }
+      }
+      llvm::lto::SymbolResolution resolution;
+      if (!symbol.isUndefined() &&
+          defined_symbols.insert(symbol.getName()).second) {
+        resolution.Prevailing = true;
+        resolution.FinalDefinitionInLinkageUnit = true;
+      }
+      resolution.VisibleToRegularObj =
+          preserved_symbols.contains(symbol.getName());
+      resolutions.push_back(resolution);
+    }
+
+    if (auto error = lto.add(std::move(*input_file), resolutions)) {
+      errors << "ERROR: Unable to add bitcode file '"
+             << input->getBufferIdentifier()
+             << "': " << llvm::toString(std::move(error)) << "\n";
+      return false;
+    }
+  }
+
+  // Each backend task writes its own object file. Tasks run concurrently, so
+  // failures are reported through the returned error rather than `errors`.
+  auto add_stream = [&](size_t task, const llvm::Twine& /*module_name*/)
+      -> llvm::Expected<std::unique_ptr<llvm::CachedFileStream>> {
+    std::string output_file_name =
+        (options.output_prefix + "." + llvm::Twine(task) + ".o").str();
+    std::error_code ec;
+    auto output_file = std::make_unique<llvm::raw_fd_ostream>(
+        output_file_name, ec, llvm::sys::fs::OF_None);
+    if (ec) {
+      return llvm::createStringError(ec, "Could not open output file '%s'",
+                                     output_file_name.c_str());
+    }
+    return std::make_unique<llvm::CachedFileStream>(std::move(output_file),
+                                                    output_file_name);
+  };
+  if (auto error = lto.run(add_stream)) {
+    errors << "ERROR: Link-time optimization failed: "
+           << llvm::toString(std::move(error)) << "\n";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace Carbon
@@ -0,0 +1,48 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CARBON_TOOLCHAIN_CODEGEN_LTO_H_
+#define CARBON_TOOLCHAIN_CODEGEN_LTO_H_
+
+#include <memory>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace Carbon {
+
+// Options for `RunLinkTimeOptimization`.
+struct LinkTimeOptimizationOptions {
+  // The target to use for bitcode files that don't specify one.
+  llvm::StringRef target_triple;
+
+  // Object files are written to `<output_prefix>.<N>.o`, one per backend task.
+  llvm::StringRef output_prefix;
+
+  // Symbols that are referenced from outside the bitcode files, and so must
+  // not be internalized. `main` is always preserved.
+  llvm::ArrayRef<llvm::StringRef> preserved_symbols;
+
+  // The number of backend threads to use, or 0 to use all available cores.
+  int jobs = 0;
+};
+
+// Runs whole-program optimization over a set of bitcode files produced by
+// `compile --emit=llvm-bc`. Files with a ThinLTO summary are optimized with
+// ThinLTO, and others are merged and optimized as a single module. Symbols that
+// aren't preserved are internalized, which allows them to be inlined across
+// files and removed once unused. Code generation runs in parallel.
+//
+// Returns false in case of failure, and any information about the failure is
+// printed to `errors`.
+auto RunLinkTimeOptimization(
+    llvm::ArrayRef<std::unique_ptr<llvm::MemoryBuffer>> inputs,
+    const LinkTimeOptimizationOptions& options, llvm::raw_ostream& errors)
+    -> bool;
+
+}  // namespace Carbon
+
+#endif  // CARBON_TOOLCHAIN_CODEGEN_LTO_H_
@@ -0,0 +1,133 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Benchmarks the toolchain phases over a corpus of Carbon files, such as the
+// ports in `third_party/examples`. Unlike the per-phase microbenchmarks, this
+// is intended to reflect the shape of real code.
+//
+// Usage:
+//   compile_benchmark [--benchmark_*] [--max_replicas=N] <file.carbon>...
+//
+// The corpus is replicated from 1 up to `--max_replicas` times to measure how
+// throughput scales with input size. Files are checked only as far as they
+// get: checking stops at the first unsupported construct in a file.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "common/check.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include "toolchain/check/check.h"
+#include "toolchain/diagnostics/diagnostic_emitter.h"
+#include "toolchain/diagnostics/null_diagnostics.h"
+#include "toolchain/lex/tokenized_buffer.h"
+#include "toolchain/parse/tree.h"
+#include "toolchain/sem_ir/file.h"
+#include "toolchain/source/source_buffer.h"
+
+ABSL_FLAG(int, max_replicas, 16,
+          "The maximum number of times the corpus is replicated.");
+
+namespace Carbon {
+namespace {
+
+// The phases to run in a benchmark. Each includes all prior phases.
+enum class Phase : int8_t { Lex, Parse, Check };
+
+// The corpus of source files, loaded once before benchmarking.
+auto Corpus() -> llvm::SmallVector<SourceBuffer>& {
+  static llvm::SmallVector<SourceBuffer> corpus;
+  return corpus;
+}
+
+// Runs the phases up to `phase` over `replicas` copies of the corpus.
+auto BM_Corpus(benchmark::State& state, Phase phase) -> void {
+  DiagnosticConsumer& consumer = NullDiagnosticConsumer();
+  auto builtins = Check::MakeBuiltins();
+  int replicas = state.range(0);
+
+  int64_t num_tokens = 0;
+  int64_t num_nodes = 0;
+  for (auto _ : state) {
+    num_tokens = 0;
+    num_nodes = 0;
+    for (int replica = 0; replica < replicas; ++replica) {
+      for (SourceBuffer& source : Corpus()) {
+        auto tokens = Lex::TokenizedBuffer::Lex(source, consumer);
+        num_tokens += tokens.size();
+        if (phase == Phase::Lex) {
+          benchmark::DoNotOptimize(tokens.has_errors());
+          continue;
+        }
+
+        auto tree = Parse::Tree::Parse(tokens, consumer,
+                                       /*vlog_stream=*/nullptr);
+        num_nodes += tree.size();
+        if (phase == Phase::Parse) {
+          benchmark::DoNotOptimize(tree.has_errors());
+          continue;
+        }
+
+        auto sem_ir =
+            Check::CheckParseTree(builtins, /*import_irs=*/{}, tokens, tree,
+                                  consumer, /*vlog_stream=*/nullptr);
+        benchmark::DoNotOptimize(sem_ir.has_errors());
+      }
+    }
+  }
+
+  state.counters["tokens_per_second"] = benchmark::Counter(
+      num_tokens, benchmark::Counter::kIsIterationInvariantRate);
+  if (phase != Phase::Lex) {
+    state.counters["nodes_per_second"] = benchmark::Counter(
+        num_nodes, benchmark::Counter::kIsIterationInvariantRate);
+  }
+}
+
+}  // namespace
+}  // namespace Carbon
+
+auto main(int argc, char** argv) -> int {
+  benchmark::Initialize(&argc, argv);
+  std::vector<char*> files = absl::ParseCommandLine(argc, argv);
+  // Drop the program name.
+  files.erase(files.begin());
+  if (files.empty()) {
+    llvm::errs() << "Usage: " << argv[0]
+                 << " [--benchmark_*] [--max_replicas=N] <file.carbon>...\n";
+    return EXIT_FAILURE;
+  }
+
+  auto fs = llvm::vfs::getRealFileSystem();
+  for (const char* file : files) {
+    auto source = Carbon::SourceBuffer::CreateFromFile(
+        *fs, file, Carbon::ConsoleDiagnosticConsumer());
+    if (!source) {
+      return EXIT_FAILURE;
+    }
+    Carbon::Corpus().push_back(std::move(*source));
+  }
+
+  int max_replicas = absl::GetFlag(FLAGS_max_replicas);
+  for (auto [name, phase] :
+       {std::pair{"BM_Lex", Carbon::Phase::Lex},
+        std::pair{"BM_LexParse", Carbon::Phase::Parse},
+        std::pair{"BM_LexParseCheck", Carbon::Phase::Check}}) {
+    benchmark::RegisterBenchmark(name, Carbon::BM_Corpus, phase)
+        ->RangeMultiplier(4)
+        ->Range(1, max_replicas)
+        ->Unit(benchmark::kMillisecond);
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return EXIT_SUCCESS;
+}
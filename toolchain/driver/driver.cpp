@@ -4,8 +4,11 @@
 
 #include "toolchain/driver/driver.h"
 
+#include <map>
 #include <memory>
 #include <optional>
+#include <string>
+#include <utility>
 
 #include "common/command_line.h"
 #include "common/vlog.h"
@@ -14,16 +17,20 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/Support/Path.h"
 #include "llvm/TargetParser/Host.h"
 #include "toolchain/check/check.h"
 #include "toolchain/codegen/codegen.h"
+#include "toolchain/codegen/lto.h"
 #include "toolchain/diagnostics/diagnostic_emitter.h"
 #include "toolchain/diagnostics/sorting_diagnostic_consumer.h"
+#include "toolchain/driver/unit_dependency_graph.h"
 #include "toolchain/lex/tokenized_buffer.h"
 #include "toolchain/lower/lower.h"
 #include "toolchain/parse/tree.h"
 #include "toolchain/sem_ir/formatter.h"
+#include "toolchain/sem_ir/pass_manager.h"
 #include "toolchain/source/source_buffer.h"
 
 namespace Carbon {
@@ -52,6 +59,16 @@ can be written to standard output as these phases progress.
     CodeGen,
   };
 
+  enum class Emit : int8_t {
+    MachineCode,
+    LlvmBitcode,
+  };
+
+  enum class Schedule : int8_t {
+    BreadthFirst,
+    DepthFirst,
+  };
+
   friend auto operator<<(llvm::raw_ostream& out, Phase phase)
       -> llvm::raw_ostream& {
     switch (phase) {
@@ -108,6 +125,85 @@ compile to machine code.
               &phase);
         });
 
+    b.AddOneOfOption(
+        {
+            .name = "emit",
+            .help = R"""(
+Selects what the codegen phase produces. The default, `machine-code`, writes
+assembly or an object file as described by `--output`. `llvm-bc` writes LLVM
+bitcode instead, which can be optimized across files by the `lto` subcommand.
+)""",
+        },
+        [&](auto& arg_b) {
+          arg_b.SetOneOf(
+              {
+                  arg_b.OneOfValue("machine-code", Emit::MachineCode)
+                      .Default(true),
+                  arg_b.OneOfValue("llvm-bc", Emit::LlvmBitcode),
+              },
+              &emit);
+        });
+
+    b.AddIntegerOption(
+        {
+            .name = "jobs",
+            .help = R"""(
+The number of threads to use for checking. Each file is checked after the files
+it depends on, such as the API file of its library, and files that don't depend
+on each other are checked concurrently. A value of 0 uses all available cores.
+The default is to check one file at a time.
+
+Diagnostics are printed in the order of the input files regardless. When
+`--stream-errors` is used, or with `--schedule=depth-first`, files are checked
+one at a time.
+)""",
+        },
+        [&](auto& arg_b) {
+          arg_b.Default(1);
+          arg_b.Set(&jobs);
+        });
+
+    b.AddOneOfOption(
+        {
+            .name = "schedule",
+            .help = R"""(
+Selects the order in which input files are carried through the phases.
+
+The default, `breadth-first`, runs each phase on every file before starting the
+next phase, and doesn't lower any file if any file has errors. `depth-first`
+carries each file through every phase before starting the next file, releasing
+its intermediate results as soon as they're no longer needed. This bounds peak
+memory use by the largest file rather than the sum of all files, at the cost of
+producing output for earlier files even if a later one has errors. Only the
+SemIR of each library's API file is kept, for its `impl` files to import from,
+so the API file must come before them. Diagnostics are printed in the order of
+the input files in either case.
+)""",
+        },
+        [&](auto& arg_b) {
+          arg_b.SetOneOf(
+              {
+                  arg_b.OneOfValue("breadth-first", Schedule::BreadthFirst)
+                      .Default(true),
+                  arg_b.OneOfValue("depth-first", Schedule::DepthFirst),
+              },
+              &schedule);
+        });
+
+    b.AddFlag(
+        {
+            .name = "thin-lto",
+            .help = R"""(
+Include a ThinLTO summary when emitting LLVM bitcode.
+
+Bitcode with a summary is optimized with ThinLTO by the `lto` subcommand, which
+imports only the functions worth inlining into each module and optimizes modules
+in parallel. Bitcode without a summary is merged into a single module for full
+LTO. Requires `--emit=llvm-bc`.
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Set(&thin_lto); });
+
     // TODO: Rearrange the code setting this option and two related ones to
     // allow them to reference each other instead of hard-coding their names.
     b.AddStringOption(
@@ -119,7 +215,8 @@ The output filename for codegen.
 
 When this is a file name, either textual assembly or a binary object will be
 written to it based on the flag `--asm-output`. The default is to write a binary
-object file.
+object file. With `--emit=llvm-bc`, bitcode is written instead, and the default
+file name uses the `.bc` extension.
 
 Passing `--output=-` will write the output to stdout. In that
 case, the flag `--asm-output` is ignored and the output defaults to textual
@@ -145,6 +242,46 @@ https://clang.llvm.org/docs/CrossCompilation.html#target-triple
           arg_b.Set(&target);
         });
 
+    b.AddFlag(
+        {
+            .name = "pass-aggregates-in-registers",
+            .help = R"""(
+Pass and return small structs and tuples in registers, following the C calling
+convention of the `--target` platform, rather than by pointer to memory.
+
+This changes the calling convention of lowered functions, so all files that
+call each other must be compiled with the same setting.
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Set(&pass_aggregates_in_registers); });
+
+    b.AddFlag(
+        {
+            .name = "profile-generate",
+            .help = R"""(
+Instrument the generated code to count function entries and branch outcomes.
+
+Running the instrumented program writes a raw profile, which can be merged with
+`llvm-profdata merge` and passed back in with `--profile-use`.
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Set(&profile_generate); });
+
+    b.AddStringOption(
+        {
+            .name = "profile-use",
+            .value_name = "FILE",
+            .help = R"""(
+Use an indexed profile, collected from a `--profile-generate` build, to guide
+code generation.
+
+Branches are annotated with the weights observed in the profile, and functions
+with their entry counts, so that code generation can lay out hot paths first.
+Functions that have changed since the profile was collected are not annotated.
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Set(&profile_use); });
+
     b.AddFlag(
         {
             .name = "asm-output",
@@ -229,6 +366,38 @@ Include the SemIR for builtins when dumping it.
 )""",
         },
         [&](auto& arg_b) { arg_b.Set(&builtin_sem_ir); });
+    b.AddStringOption(
+        {
+            .name = "sem-ir-passes",
+            .value_name = "PASS,...",
+            .help = R"""(
+A comma-separated list of passes to run over the SemIR of each file after it is
+checked, in order. Passes only run on files without errors. Available passes
+are:
+
+  forward-name-references, value-numbering, remove-no-ops,
+  remove-unreachable-blocks, merge-blocks
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Set(&sem_ir_passes); });
+    b.AddFlag(
+        {
+            .name = "dump-sem-ir-before-passes",
+            .help = R"""(
+Dump the SemIR to stdout before running the passes requested by
+`--sem-ir-passes`. Combined with `--dump-sem-ir`, this shows what the passes
+changed.
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Set(&dump_sem_ir_before_passes); });
+    b.AddFlag(
+        {
+            .name = "time-passes",
+            .help = R"""(
+Print the time spent in each SemIR pass to stderr once compilation finishes.
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Set(&time_passes); });
     b.AddFlag(
         {
             .name = "dump-llvm-ir",
@@ -248,24 +417,122 @@ Dump the generated assembly to stdout after codegen.
   }
 
   Phase phase;
+  Emit emit;
+  Schedule schedule;
 
   std::string host = llvm::sys::getDefaultTargetTriple();
   llvm::StringRef target;
 
   llvm::StringRef output_file_name;
   llvm::SmallVector<llvm::StringRef> input_file_names;
+  llvm::StringRef sem_ir_passes;
+  llvm::StringRef profile_use;
+  int jobs = 1;
 
+  bool pass_aggregates_in_registers = false;
+  bool profile_generate = false;
+  bool thin_lto = false;
   bool asm_output = false;
   bool force_obj_output = false;
   bool dump_tokens = false;
   bool dump_parse_tree = false;
   bool dump_raw_sem_ir = false;
   bool dump_sem_ir = false;
+  bool dump_sem_ir_before_passes = false;
   bool dump_llvm_ir = false;
   bool dump_asm = false;
   bool stream_errors = false;
   bool preorder_parse_tree = false;
   bool builtin_sem_ir = false;
+  bool time_passes = false;
+};
+
+struct Driver::LtoOptions {
+  static constexpr CommandLine::CommandInfo Info = {
+      .name = "lto",
+      .help = R"""(
+Optimize LLVM bitcode from multiple Carbon files together.
+
+This subcommand takes bitcode produced by `compile --emit=llvm-bc`, links it,
+and runs whole-program optimization over it. Functions are inlined across file
+boundaries, and symbols that aren't needed outside of the linked bitcode are
+internalized and removed once unused. Object files are then generated in
+parallel, and should be passed to the system linker.
+)""",
+  };
+
+  void Build(CommandLine::CommandBuilder& b) {
+    b.AddStringPositionalArg(
+        {
+            .name = "FILE",
+            .help = R"""(
+An input LLVM bitcode file.
+)""",
+        },
+        [&](auto& arg_b) {
+          arg_b.Required(true);
+          arg_b.Append(&input_file_names);
+        });
+
+    b.AddStringOption(
+        {
+            .name = "output",
+            .value_name = "PREFIX",
+            .help = R"""(
+The prefix for output object files. Each parallel code generation task writes
+`PREFIX.N.o`, where `N` is the task number.
+)""",
+        },
+        [&](auto& arg_b) {
+          arg_b.Default("a.out");
+          arg_b.Set(&output_prefix);
+        });
+
+    b.AddStringOption(
+        {
+            .name = "target",
+            .help = R"""(
+Select a target platform for bitcode files that don't already specify one. Uses
+the LLVM target syntax.
+)""",
+        },
+        [&](auto& arg_b) {
+          arg_b.Default(host);
+          arg_b.Set(&target);
+        });
+
+    b.AddStringOption(
+        {
+            .name = "preserve-symbol",
+            .value_name = "NAME",
+            .help = R"""(
+A symbol that is referenced from outside of the input bitcode, and so must not
+be internalized. May be repeated. `main` is always preserved.
+)""",
+        },
+        [&](auto& arg_b) { arg_b.Append(&preserved_symbols); });
+
+    b.AddIntegerOption(
+        {
+            .name = "jobs",
+            .help = R"""(
+The number of threads to use for optimization and code generation. The default
+of 0 uses all available cores.
+)""",
+        },
+        [&](auto& arg_b) {
+          arg_b.Default(0);
+          arg_b.Set(&jobs);
+        });
+  }
+
+  std::string host = llvm::sys::getDefaultTargetTriple();
+  llvm::StringRef target;
+
+  llvm::StringRef output_prefix;
+  llvm::SmallVector<llvm::StringRef> input_file_names;
+  llvm::SmallVector<llvm::StringRef> preserved_symbols;
+  int jobs = 0;
 };
 
 struct Driver::Options {
@@ -290,6 +557,7 @@ For questions, issues, or bug reports, please use our GitHub project:
 
   enum class Subcommand : int8_t {
     Compile,
+    Lto,
   };
 
   void Build(CommandLine::CommandBuilder& b) {
@@ -307,6 +575,11 @@ For questions, issues, or bug reports, please use our GitHub project:
                       sub_b.Do([&] { subcommand = Subcommand::Compile; });
                     });
 
+    b.AddSubcommand(LtoOptions::Info, [&](CommandLine::CommandBuilder& sub_b) {
+      lto_options.Build(sub_b);
+      sub_b.Do([&] { subcommand = Subcommand::Lto; });
+    });
+
     b.RequiresSubcommand();
   }
 
@@ -314,6 +587,7 @@ For questions, issues, or bug reports, please use our GitHub project:
   Subcommand subcommand;
 
   CompileOptions compile_options;
+  LtoOptions lto_options;
 };
 
 auto Driver::ParseArgs(llvm::ArrayRef<llvm::StringRef> args, Options& options)
@@ -340,6 +614,8 @@ auto Driver::RunCommand(llvm::ArrayRef<llvm::StringRef> args) -> bool {
   switch (options.subcommand) {
     case Options::Subcommand::Compile:
       return Compile(options.compile_options);
+    case Options::Subcommand::Lto:
+      return Lto(options.lto_options);
   }
   llvm_unreachable("All subcommands handled!");
 }
@@ -357,12 +633,18 @@ auto Driver::ValidateCompileOptions(const CompileOptions& options) const
       }
       [[clang::fallthrough]];
     case Phase::Parse:
-      if (options.dump_sem_ir) {
+      if (options.dump_sem_ir || options.dump_sem_ir_before_passes) {
         error_stream_ << "ERROR: Requested dumping the SemIR but compile phase "
                          "is limited to '"
                       << options.phase << "'\n";
         return false;
       }
+      if (!options.sem_ir_passes.empty()) {
+        error_stream_ << "ERROR: Requested SemIR passes but compile phase is "
+                         "limited to '"
+                      << options.phase << "'\n";
+        return false;
+      }
       [[clang::fallthrough]];
     case Phase::Check:
       if (options.dump_llvm_ir) {
@@ -377,12 +659,32 @@ auto Driver::ValidateCompileOptions(const CompileOptions& options) const
       // Everything can be dumped in these phases.
       break;
   }
+  if (options.thin_lto && options.emit != CompileOptions::Emit::LlvmBitcode) {
+    error_stream_ << "ERROR: Requested a ThinLTO summary but not emitting "
+                     "LLVM bitcode\n";
+    return false;
+  }
+  if (options.profile_generate && !options.profile_use.empty()) {
+    error_stream_ << "ERROR: Requested both generating and using a profile\n";
+    return false;
+  }
+  if (options.jobs < 0) {
+    error_stream_ << "ERROR: Requested a negative number of jobs: "
+                  << options.jobs << "\n";
+    return false;
+  }
   return true;
 }
 
 // Ties together information for a file being compiled.
 class Driver::CompilationUnit {
  public:
+  // Returns the SemIR that a file with the given `package` directive imports
+  // names from.
+  using GetImportIRsFn =
+      llvm::function_ref<auto(const std::optional<PackageDirective>&)
+                             ->llvm::SmallVector<const SemIR::File*>>;
+
   explicit CompilationUnit(Driver* driver, const CompileOptions& options,
                            llvm::StringRef input_file_name)
       : driver_(driver),
@@ -439,24 +741,61 @@ class Driver::CompilationUnit {
     return !parse_tree_->has_errors();
   }
 
-  // Check the parse tree and produce SemIR. Returns true on success.
-  auto RunCheck(const SemIR::File& builtins) -> bool {
+  // Returns the parsed `package` directive, or nullopt if there isn't one.
+  auto GetPackageDirective() const -> std::optional<PackageDirective> {
+    if (!parse_tree_) {
+      return std::nullopt;
+    }
+    return Carbon::GetPackageDirective(*tokens_, *parse_tree_);
+  }
+
+  // Checks the parse tree and produces SemIR, importing names from the SemIR of
+  // `import_irs`. Unless diagnostics are streamed or verbose logging is
+  // enabled, this produces no output, and so can run concurrently with checking
+  // other units. `FinishCheck` must be called after.
+  auto RunCheck(const SemIR::File& builtins,
+                llvm::ArrayRef<const SemIR::File*> import_irs) -> void {
     // Can be called when the file fails to load, so ensure there's source.
     if (!source_) {
-      return false;
+      return;
     }
     CARBON_CHECK(parse_tree_);
 
     LogCall("Check::CheckParseTree", [&] {
-      sem_ir_ = Check::CheckParseTree(builtins, *tokens_, *parse_tree_,
-                                      *consumer_, vlog_stream_);
+      sem_ir_ = Check::CheckParseTree(builtins, import_irs, *tokens_,
+                                      *parse_tree_, *consumer_, vlog_stream_);
     });
+  }
+
+  // Returns the SemIR produced by `RunCheck`, or null if there is none.
+  auto sem_ir() const -> const SemIR::File* {
+    return sem_ir_ ? &*sem_ir_ : nullptr;
+  }
+
+  // Reports the results of `RunCheck`, then runs the requested passes over the
+  // SemIR. Returns true on success.
+  auto FinishCheck(SemIR::PassManager& pass_manager) -> bool {
+    if (!source_) {
+      return false;
+    }
+    CARBON_CHECK(sem_ir_);
 
     // We've finished all steps that can produce diagnostics. Emit the
     // diagnostics now, so that the developer sees them sooner and doesn't need
     // to wait for code generation.
     consumer_->Flush();
 
+    if (!sem_ir_->has_errors() && !pass_manager.empty()) {
+      if (options_.dump_sem_ir_before_passes) {
+        SemIR::FormatFile(*tokens_, *parse_tree_, *sem_ir_,
+                          driver_->output_stream_);
+        if (options_.dump_sem_ir) {
+          driver_->output_stream_ << "\n";
+        }
+      }
+      LogCall("SemIR::PassManager::Run", [&] { pass_manager.Run(*sem_ir_); });
+    }
+
     CARBON_VLOG() << "*** Raw SemIR::File ***\n" << *sem_ir_ << "\n";
     if (options_.dump_raw_sem_ir) {
       sem_ir_->Print(driver_->output_stream_, options_.builtin_sem_ir);
@@ -477,13 +816,13 @@ class Driver::CompilationUnit {
   }
 
   // Lower SemIR to LLVM IR.
-  auto RunLower() -> void {
+  auto RunLower(const Lower::LowerOptions& lower_options) -> void {
     CARBON_CHECK(sem_ir_);
 
     LogCall("Lower::LowerToLLVM", [&] {
       llvm_context_ = std::make_unique<llvm::LLVMContext>();
       module_ = Lower::LowerToLLVM(*llvm_context_, input_file_name_, *sem_ir_,
-                                   vlog_stream_);
+                                   lower_options, vlog_stream_);
     });
     if (vlog_stream_) {
       CARBON_VLOG() << "*** llvm::Module ***\n";
@@ -512,6 +851,10 @@ class Driver::CompilationUnit {
       codegen->EmitAssembly(*vlog_stream_);
     }
 
+    if (options_.emit == CompileOptions::Emit::LlvmBitcode) {
+      return EmitBitcode(*codegen);
+    }
+
     if (options_.output_file_name == "-") {
       // TODO: the output file name, forcing object output, and requesting
       // textual assembly output are all somewhat linked flags. We should add
@@ -557,10 +900,90 @@ class Driver::CompilationUnit {
     return true;
   }
 
+  // Runs every requested phase, releasing each intermediate result once later
+  // phases no longer need it. Once the file is parsed, `get_import_irs` is
+  // given its `package` directive, and returns the SemIR to import names from.
+  // The SemIR of a library's `api` file is kept so that its `impl` files can
+  // import from it. Lowering and codegen are skipped if this unit has errors,
+  // or if `allow_lower` is false because an earlier unit did. Returns true on
+  // success.
+  auto RunAllPhases(const SemIR::File& builtins,
+                    SemIR::PassManager& pass_manager,
+                    const Lower::LowerOptions& lower_options, bool allow_lower,
+                    GetImportIRsFn get_import_irs) -> bool {
+    using Phase = CompileOptions::Phase;
+    bool success = RunLex();
+    if (options_.phase == Phase::Lex) {
+      return success;
+    }
+    success &= RunParse();
+    if (options_.phase == Phase::Parse) {
+      return success;
+    }
+    std::optional<PackageDirective> directive = GetPackageDirective();
+    bool is_api = directive && !directive->is_impl;
+    RunCheck(builtins, get_import_irs(directive));
+    success &= FinishCheck(pass_manager);
+    // Check flushes diagnostics and writes any dumps, and the SemIR owns its
+    // strings, so nothing from earlier phases is needed after this.
+    parse_tree_.reset();
+    tokens_.reset();
+    source_.reset();
+    if (options_.phase == Phase::Check) {
+      return success;
+    }
+    if (!success || !allow_lower) {
+      CARBON_VLOG() << "*** Stopping before lowering due to errors ***\n";
+      return success;
+    }
+
+    RunLower(lower_options);
+    if (!is_api) {
+      sem_ir_.reset();
+    }
+    if (options_.phase == Phase::Lower) {
+      return true;
+    }
+    CARBON_CHECK(options_.phase == Phase::CodeGen)
+        << "CodeGen should be the last stage";
+
+    success = RunCodeGen();
+    module_.reset();
+    llvm_context_.reset();
+    return success;
+  }
+
   // Flushes output.
   auto Flush() -> void { consumer_->Flush(); }
 
  private:
+  // Writes LLVM bitcode for codegen output. Returns true on success.
+  auto EmitBitcode(CodeGen& codegen) -> bool {
+    if (options_.output_file_name == "-") {
+      codegen.EmitBitcode(driver_->output_stream_, options_.thin_lto);
+      return true;
+    }
+
+    llvm::SmallString<256> output_file_name = options_.output_file_name;
+    if (output_file_name.empty()) {
+      output_file_name = input_file_name_;
+      llvm::sys::path::replace_extension(output_file_name, ".bc");
+    }
+    CARBON_VLOG() << "Writing bitcode to: " << output_file_name << "\n";
+
+    std::error_code ec;
+    llvm::raw_fd_ostream output_file(output_file_name, ec,
+                                     llvm::sys::fs::OF_None);
+    if (ec) {
+      driver_->error_stream_ << "ERROR: Could not open output file '"
+                             << output_file_name << "': " << ec.message()
+                             << "\n";
+      return false;
+    }
+    codegen.EmitBitcode(output_file, options_.thin_lto);
+    return true;
+  }
+
   // Wraps a call with log statements to indicate start and end.
   auto LogCall(llvm::StringLiteral label, llvm::function_ref<void()> fn)
       -> void {
@@ -595,6 +1018,109 @@ auto Driver::Compile(const CompileOptions& options) -> bool {
     return false;
   }
 
+  SemIR::PassManager pass_manager(vlog_stream_);
+  if (auto result = pass_manager.AddPasses(options.sem_ir_passes);
+      !result.ok()) {
+    error_stream_ << "ERROR: " << result.error().message() << "\n";
+    return false;
+  }
+  if (options.time_passes) {
+    pass_manager.EnableTiming();
+  }
+  auto print_timings = llvm::make_scope_exit(
+      [&]() { pass_manager.PrintTimings(error_stream_); });
+
+  // Lowering options are shared by all units.
+  Lower::LowerOptions lower_options = {
+      .target_triple = options.target,
+      .aggregate_abi = options.pass_aggregates_in_registers
+                           ? Lower::AggregateAbi::ForTarget(options.target)
+                           : Lower::AggregateAbi(),
+      .profile_generate = options.profile_generate};
+  std::optional<llvm::DataLayout> data_layout;
+  if (options.phase >= CompileOptions::Phase::Lower) {
+    data_layout = CodeGen::GetDataLayout(options.target, error_stream_);
+    if (!data_layout) {
+      return false;
+    }
+    lower_options.data_layout = &*data_layout;
+  }
+  std::unique_ptr<llvm::IndexedInstrProfReader> profile_reader;
+  if (!options.profile_use.empty()) {
+    auto buffer = fs_.getBufferForFile(options.profile_use);
+    if (!buffer) {
+      error_stream_ << "ERROR: Could not read profile '" << options.profile_use
+                    << "': " << buffer.getError().message() << "\n";
+      return false;
+    }
+    auto reader = llvm::IndexedInstrProfReader::create(std::move(*buffer));
+    if (!reader) {
+      error_stream_ << "ERROR: Could not read profile '" << options.profile_use
+                    << "': " << llvm::toString(reader.takeError()) << "\n";
+      return false;
+    }
+    profile_reader = std::move(*reader);
+    lower_options.profile_reader = profile_reader.get();
+  }
+
+  if (options.schedule == CompileOptions::Schedule::DepthFirst) {
+    // Only one unit is alive at a time, apart from the SemIR of `api` files,
+    // which later `impl` files import from. A unit's diagnostics are flushed
+    // before moving on, which keeps them in order of arguments.
+    auto builtins = Check::MakeBuiltins();
+    bool success = true;
+    // The units of `api` files, and whether an `impl` file has been seen, for
+    // each library by package and library name. Names are copied because each
+    // unit's tokens are released after checking.
+    struct Library {
+      llvm::SmallVector<std::unique_ptr<CompilationUnit>, 1> api_units;
+      bool has_impl = false;
+    };
+    std::map<std::pair<std::string, std::string>, Library> libraries;
+    for (const auto& input_file_name : options.input_file_names) {
+      auto unit =
+          std::make_unique<CompilationUnit>(this, options, input_file_name);
+      // The library that this unit is the `api` file of, if any.
+      Library* api_of = nullptr;
+      bool unit_success = unit->RunAllPhases(
+          builtins, pass_manager, lower_options, success,
+          [&](const std::optional<PackageDirective>& directive)
+              -> llvm::SmallVector<const SemIR::File*> {
+            if (!directive) {
+              return {};
+            }
+            Library& library = libraries[{directive->package.str(),
+                                          directive->library.str()}];
+            if (!directive->is_impl) {
+              api_of = &library;
+              return {};
+            }
+            library.has_impl = true;
+            llvm::SmallVector<const SemIR::File*> import_irs;
+            for (const auto& api_unit : library.api_units) {
+              if (const auto* sem_ir = api_unit->sem_ir()) {
+                import_irs.push_back(sem_ir);
+              }
+            }
+            return import_irs;
+          });
+      unit->Flush();
+      success &= unit_success;
+      if (api_of) {
+        if (api_of->has_impl) {
+          // An earlier `impl` file couldn't import from this file.
+          error_stream_ << "ERROR: With `--schedule=depth-first`, the `api` "
+                           "file of a library must come before its `impl` "
+                           "files: "
+                        << input_file_name << "\n";
+          success = false;
+        }
+        api_of->api_units.push_back(std::move(unit));
+      }
+    }
+    return success;
+  }
+
   llvm::SmallVector<std::unique_ptr<CompilationUnit>> units;
   auto flush = llvm::make_scope_exit([&]() {
     // The diagnostics consumer must be flushed before compilation artifacts are
@@ -626,11 +1152,29 @@ auto Driver::Compile(const CompileOptions& options) -> bool {
     return success_before_lower;
   }
 
-  // Check.
+  // Check. Each unit is checked after the units it depends on, which it
+  // imports from, and independent units are checked concurrently. Results are
+  // reported afterwards, in order of arguments. Diagnostics that are streamed
+  // can't be reordered, so those units are checked serially.
   auto builtins = Check::MakeBuiltins();
-  // TODO: Organize units to compile in dependency order.
+  llvm::SmallVector<std::optional<PackageDirective>> package_directives;
   for (auto& unit : units) {
-    success_before_lower &= unit->RunCheck(builtins);
+    package_directives.push_back(unit->GetPackageDirective());
+  }
+  UnitDependencyGraph dependency_graph(package_directives);
+  int check_jobs =
+      (vlog_stream_ != nullptr || options.stream_errors) ? 1 : options.jobs;
+  dependency_graph.RunInDependencyOrder(check_jobs, [&](int unit) {
+    llvm::SmallVector<const SemIR::File*> import_irs;
+    for (int dependency : dependency_graph.dependencies(unit)) {
+      if (const auto* sem_ir = units[dependency]->sem_ir()) {
+        import_irs.push_back(sem_ir);
+      }
+    }
+    units[unit]->RunCheck(builtins, import_irs);
+  });
+  for (auto& unit : units) {
+    success_before_lower &= unit->FinishCheck(pass_manager);
   }
   if (options.phase == CompileOptions::Phase::Check) {
     return success_before_lower;
@@ -644,7 +1188,7 @@ auto Driver::Compile(const CompileOptions& options) -> bool {
 
   // Lower.
   for (auto& unit : units) {
-    unit->RunLower();
+    unit->RunLower(lower_options);
   }
   if (options.phase == CompileOptions::Phase::Lower) {
     return true;
@@ -660,4 +1204,34 @@ auto Driver::Compile(const CompileOptions& options) -> bool {
   return codegen_success;
 }
 
+auto Driver::Lto(const LtoOptions& options) -> bool {
+  if (options.jobs < 0) {
+    error_stream_ << "ERROR: Requested a negative number of jobs: "
+                  << options.jobs << "\n";
+    return false;
+  }
+
+  llvm::SmallVector<std::unique_ptr<llvm::MemoryBuffer>> inputs;
+  for (auto input_file_name : options.input_file_names) {
+    auto buffer = fs_.getBufferForFile(input_file_name);
+    if (!buffer) {
+      error_stream_ << "ERROR: Could not open input file '" << input_file_name
+                    << "': " << buffer.getError().message() << "\n";
+      return false;
+    }
+    inputs.push_back(std::move(*buffer));
+  }
+
+  CARBON_VLOG() << "*** RunLinkTimeOptimization ***\n";
+  bool success = RunLinkTimeOptimization(
+      inputs,
+      {.target_triple = options.target,
+       .output_prefix = options.output_prefix,
+       .preserved_symbols = options.preserved_symbols,
+       .jobs = options.jobs},
+      error_stream_);
+  CARBON_VLOG() << "*** RunLinkTimeOptimization done ***\n";
+  return success;
+}
+
 }  // namespace Carbon
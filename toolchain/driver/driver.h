@@ -39,6 +39,7 @@ class Driver {
  private:
   struct Options;
   struct CompileOptions;
+  struct LtoOptions;
   class CompilationUnit;
 
   // Delegates to the command line library to parse the arguments and store the
@@ -53,6 +54,9 @@ class Driver {
   // Implements the compile subcommand of the driver.
   auto Compile(const CompileOptions& options) -> bool;
 
+  // Implements the lto subcommand of the driver.
+  auto Lto(const LtoOptions& options) -> bool;
+
   llvm::vfs::FileSystem& fs_;
   llvm::raw_pwrite_stream& output_stream_;
   llvm::raw_pwrite_stream& error_stream_;
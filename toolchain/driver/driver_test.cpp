@@ -10,10 +10,15 @@
 #include <filesystem>
 #include <fstream>
 #include <utility>
+#include <vector>
 
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Object/Binary.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/ProfileData/InstrProfWriter.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Regex.h"
 #include "testing/base/test_raw_ostream.h"
 #include "toolchain/testing/yaml_test_helpers.h"
 
@@ -22,8 +27,18 @@ namespace {
 
 using ::Carbon::Testing::TestRawOstream;
 using ::testing::_;
+using ::testing::AllOf;
+using ::testing::Contains;
 using ::testing::ContainsRegex;
+using ::testing::Each;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::MatchesRegex;
+using ::testing::Not;
+using ::testing::Pair;
+using ::testing::SizeIs;
+using ::testing::StartsWith;
 using ::testing::StrEq;
 
 namespace Yaml = ::Carbon::Testing::Yaml;
@@ -144,6 +159,91 @@ TEST_F(DriverTest, DumpParseTree) {
               Yaml::IsYaml(_));
 }
 
+TEST_F(DriverTest, DumpRawSemIR) {
+  auto input = CreateTestFile("fn F() { var x: i32 = 0; return; }");
+  EXPECT_TRUE(driver_.RunCommand(
+      {"compile", "--phase=check", "--dump-raw-sem-ir", input}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+
+  // Matches the ID of a node. The numbers may change because of builtin
+  // cross-references, so this code is only doing loose structural checks.
+  auto node_id = Yaml::Scalar(MatchesRegex(R"(node\+\d+)"));
+  auto node_builtin = Yaml::Scalar(MatchesRegex(R"(node\w+)"));
+  auto type_id = Yaml::Scalar(MatchesRegex(R"(type\d+)"));
+
+  auto file = Yaml::Sequence(ElementsAre(Yaml::Mapping(ElementsAre(
+      Pair("cross_reference_irs_size", "1"),
+      Pair("functions", Yaml::Sequence(SizeIs(1))),
+      Pair("integer_literals", Yaml::Sequence(ElementsAre("0"))),
+      Pair("real_literals", Yaml::Sequence(IsEmpty())),
+      Pair("strings", Yaml::Sequence(ElementsAre("F", "x"))),
+      Pair("types", Yaml::Sequence(ElementsAre(node_builtin))),
+      Pair("type_blocks", Yaml::Sequence(IsEmpty())),
+      Pair("nodes",
+           Yaml::Sequence(AllOf(
+               // kind is required, other parts are optional.
+               Each(Yaml::Mapping(Contains(Pair("kind", _)))),
+               // A 0-arg node.
+               Contains(Yaml::Mapping(ElementsAre(Pair("kind", "Return")))),
+               // A 1-arg node.
+               Contains(Yaml::Mapping(
+                   ElementsAre(Pair("kind", "IntegerLiteral"),
+                               Pair("arg0", "int0"), Pair("type", type_id)))),
+               // A 2-arg node.
+               Contains(Yaml::Mapping(ElementsAre(Pair("kind", "Assign"),
+                                                  Pair("arg0", node_id),
+                                                  Pair("arg1", node_id))))))),
+      // This production has only two node blocks.
+      Pair("node_blocks",
+           Yaml::Sequence(ElementsAre(Yaml::Sequence(IsEmpty()),
+                                      Yaml::Sequence(Each(node_id)),
+                                      Yaml::Sequence(Each(node_id)))))))));
+
+  auto root = Yaml::Sequence(ElementsAre(Yaml::Mapping(
+      ElementsAre(Pair("filename", input.str()), Pair("sem_ir", file)))));
+
+  EXPECT_THAT(Yaml::Value::FromText(test_output_stream_.TakeStr()),
+              Yaml::IsYaml(ElementsAre(root)));
+}
+
+TEST_F(DriverTest, SemIRPassesWithTiming) {
+  auto file = CreateTestFile(R"(
+fn F(b: bool, n: i32) -> i32 {
+  var x: i32 = n;
+  if (b) {
+    x = n;
+  }
+  return x;
+}
+)");
+  EXPECT_TRUE(driver_.RunCommand(
+      {"compile", "--phase=lower", "--time-passes",
+       "--sem-ir-passes=forward-name-references,value-numbering,"
+       "remove-no-ops,remove-unreachable-blocks,merge-blocks",
+       file}));
+  auto errors = test_error_stream_.TakeStr();
+  EXPECT_THAT(errors, HasSubstr("SemIR pass execution timing report"));
+  EXPECT_THAT(errors, HasSubstr("merge-blocks"));
+}
+
+TEST_F(DriverTest, SemIRPassesErrors) {
+  auto file = CreateTestFile("fn F() {}");
+  EXPECT_FALSE(driver_.RunCommand(
+      {"compile", "--phase=check", "--sem-ir-passes=bogus", file}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("Unknown SemIR pass `bogus`"));
+
+  EXPECT_FALSE(driver_.RunCommand(
+      {"compile", "--phase=parse", "--sem-ir-passes=remove-no-ops", file}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("Requested SemIR passes"));
+
+  EXPECT_FALSE(driver_.RunCommand(
+      {"compile", "--phase=parse", "--dump-sem-ir-before-passes", file}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("Requested dumping the SemIR"));
+}
+
 TEST_F(DriverTest, StdoutOutput) {
   // Use explicit filenames so we can look for those to validate output.
   CreateTestFile("fn Main() -> i32 { return 0; }", "test.carbon");
@@ -191,5 +291,337 @@ TEST_F(DriverTest, FileOutput) {
   EXPECT_THAT(ReadFile("test.s"), ContainsRegex("Main:"));
 }
 
+TEST_F(DriverTest, DepthFirstSchedule) {
+  CreateTestFile("fn A() {}", "a.carbon");
+  CreateTestFile("fn B() {}", "b.carbon");
+  EXPECT_TRUE(driver_.RunCommand({"compile", "--schedule=depth-first",
+                                  "--phase=lower", "--dump-llvm-ir", "a.carbon",
+                                  "b.carbon"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  auto output = test_output_stream_.TakeStr();
+  auto a_pos = output.find("define void @A()");
+  auto b_pos = output.find("define void @B()");
+  ASSERT_NE(a_pos, std::string::npos);
+  ASSERT_NE(b_pos, std::string::npos);
+  EXPECT_LT(a_pos, b_pos);
+}
+
+TEST_F(DriverTest, DepthFirstScheduleErrors) {
+  CreateTestFile("fn A() { undeclared_a; }", "a.carbon");
+  CreateTestFile("fn B() {}", "b.carbon");
+  CreateTestFile("fn C() { undeclared_c; }", "c.carbon");
+  EXPECT_FALSE(driver_.RunCommand({"compile", "--schedule=depth-first",
+                                   "--phase=lower", "--dump-llvm-ir",
+                                   "a.carbon", "b.carbon", "c.carbon"}));
+  // Units after the first error are still checked, but not lowered.
+  EXPECT_THAT(test_output_stream_.TakeStr(), StrEq(""));
+  auto errors = test_error_stream_.TakeStr();
+  auto a_pos = errors.find("a.carbon");
+  auto c_pos = errors.find("c.carbon");
+  ASSERT_NE(a_pos, std::string::npos);
+  ASSERT_NE(c_pos, std::string::npos);
+  EXPECT_LT(a_pos, c_pos);
+}
+
+TEST_F(DriverTest, DepthFirstScheduleImportsApi) {
+  CreateTestFile("package Math api;\nfn Echo(a: i32) -> i32 { return a; }",
+                 "api.carbon");
+  CreateTestFile("package Math impl;\nfn Main() -> i32 { return Echo(1); }",
+                 "impl.carbon");
+  EXPECT_TRUE(driver_.RunCommand({"compile", "--schedule=depth-first",
+                                  "--phase=check", "api.carbon",
+                                  "impl.carbon"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+}
+
+TEST_F(DriverTest, DepthFirstScheduleImplBeforeApi) {
+  CreateTestFile("package Math api;\nfn Echo(a: i32) -> i32 { return a; }",
+                 "api.carbon");
+  CreateTestFile("package Math impl;\nfn Main() {}", "impl.carbon");
+  EXPECT_FALSE(driver_.RunCommand({"compile", "--schedule=depth-first",
+                                   "--phase=check", "impl.carbon",
+                                   "api.carbon"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("must come before its `impl` files: api.carbon"));
+}
+
+TEST_F(DriverTest, ParallelCheck) {
+  // The file system refers to file contents without copying them.
+  constexpr int NumFiles = 8;
+  std::vector<std::string> file_names;
+  std::vector<std::string> sources;
+  file_names.reserve(NumFiles);
+  sources.reserve(NumFiles);
+  for (int i = 0; i < NumFiles; ++i) {
+    file_names.push_back(llvm::formatv("file{0}.carbon", i).str());
+    sources.push_back(llvm::formatv("fn F{0}() {{ undeclared{0}; }", i).str());
+    CreateTestFile(sources.back(), file_names.back());
+  }
+  llvm::SmallVector<llvm::StringRef> args = {"compile", "--phase=check",
+                                             "--jobs=4"};
+  args.append(file_names.begin(), file_names.end());
+  EXPECT_FALSE(driver_.RunCommand(args));
+
+  // Diagnostics are printed in order of arguments, regardless of the order in
+  // which files are checked.
+  auto errors = test_error_stream_.TakeStr();
+  size_t last_pos = 0;
+  for (const auto& file_name : file_names) {
+    auto pos = errors.find(file_name);
+    ASSERT_NE(pos, std::string::npos) << file_name;
+    EXPECT_GE(pos, last_pos) << file_name;
+    last_pos = pos;
+  }
+}
+
+TEST_F(DriverTest, NegativeJobs) {
+  auto file = CreateTestFile("fn F() {}");
+  EXPECT_FALSE(
+      driver_.RunCommand({"compile", "--phase=check", "--jobs=-1", file}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("Requested a negative number of jobs: -1"));
+}
+
+TEST_F(DriverTest, BitcodeOutput) {
+  CreateTestFile("fn Main() -> i32 { return 0; }", "test.carbon");
+
+  EXPECT_TRUE(driver_.RunCommand(
+      {"compile", "--emit=llvm-bc", "--output=-", "test.carbon"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  EXPECT_THAT(test_output_stream_.TakeStr(), StartsWith("BC\xC0\xDE"));
+
+  EXPECT_FALSE(driver_.RunCommand(
+      {"compile", "--thin-lto", "--output=-", "test.carbon"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), HasSubstr("ThinLTO summary"));
+}
+
+TEST_F(DriverTest, LinkTimeOptimization) {
+  auto scope = ScopedTempWorkingDir();
+
+  CreateTestFile("fn Helper() -> i32 { return 1; }", "helper.carbon");
+  CreateTestFile("fn Helper() -> i32;\nfn Run() -> i32 { return Helper(); }",
+                 "run.carbon");
+
+  for (bool thin_lto : {false, true}) {
+    SCOPED_TRACE(thin_lto ? "ThinLTO" : "Full LTO");
+    // Compile each file to bitcode, and make it available to the driver.
+    for (llvm::StringRef name : {"helper", "run"}) {
+      std::string source = (name + ".carbon").str();
+      llvm::SmallVector<llvm::StringRef> args = {
+          "compile", "--emit=llvm-bc", "--output=-", source};
+      if (thin_lto) {
+        args.push_back("--thin-lto");
+      }
+      EXPECT_TRUE(driver_.RunCommand(args));
+      EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+      fs_.addFile(
+          (name + (thin_lto ? ".thin.bc" : ".bc")).str(),
+          /*ModificationTime=*/0,
+          llvm::MemoryBuffer::getMemBufferCopy(test_output_stream_.TakeStr()));
+    }
+
+    const char* prefix = thin_lto ? "thin" : "full";
+    EXPECT_TRUE(driver_.RunCommand(
+        {"lto", llvm::formatv("--output={0}", prefix).str(),
+         "--preserve-symbol=Run", thin_lto ? "helper.thin.bc" : "helper.bc",
+         thin_lto ? "run.thin.bc" : "run.bc"}));
+    EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+
+    // Each backend task writes an object file. Collect the flags of each
+    // symbol, keyed by the object that contains it.
+    llvm::StringMap<llvm::StringMap<uint32_t>> symbols;
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+      std::string file_name = entry.path().filename().string();
+      if (!llvm::StringRef(file_name).starts_with(prefix)) {
+        continue;
+      }
+      auto result = llvm::object::createBinary(file_name);
+      if (auto error = result.takeError()) {
+        FAIL() << toString(std::move(error));
+      }
+      auto* object =
+          llvm::dyn_cast<llvm::object::ObjectFile>(result->getBinary());
+      ASSERT_NE(object, nullptr);
+      auto& object_symbols = symbols[file_name];
+      for (const auto& symbol : object->symbols()) {
+        object_symbols[llvm::cantFail(symbol.getName())] =
+            llvm::cantFail(symbol.getFlags());
+      }
+    }
+    EXPECT_GT(symbols.size(), 0);
+
+    // `Run` is preserved, so it's defined and exported by exactly one object.
+    // Its call to `Helper` is inlined, so no object refers to `Helper`, and
+    // the object defining `Run` doesn't keep a copy of `Helper`.
+    int run_definitions = 0;
+    for (const auto& object_entry : symbols) {
+      SCOPED_TRACE(object_entry.getKey().str());
+      const auto& object_symbols = object_entry.getValue();
+      auto helper = object_symbols.find("Helper");
+      if (helper != object_symbols.end()) {
+        EXPECT_FALSE(helper->second & llvm::object::SymbolRef::SF_Undefined);
+      }
+      auto run = object_symbols.find("Run");
+      if (run == object_symbols.end()) {
+        continue;
+      }
+      EXPECT_FALSE(run->second & llvm::object::SymbolRef::SF_Undefined);
+      EXPECT_TRUE(run->second & llvm::object::SymbolRef::SF_Global);
+      EXPECT_TRUE(helper == object_symbols.end());
+      ++run_definitions;
+    }
+    EXPECT_EQ(run_definitions, 1);
+
+    // With full LTO, `Helper` is internalized, then removed once it has no
+    // remaining callers. ThinLTO can't internalize a symbol that another module
+    // refers to, so the definition in `Helper`'s own object stays exported for
+    // the system linker to remove.
+    if (!thin_lto) {
+      for (const auto& object_entry : symbols) {
+        SCOPED_TRACE(object_entry.getKey().str());
+        EXPECT_FALSE(object_entry.getValue().contains("Helper"));
+      }
+    }
+  }
+}
+
+TEST_F(DriverTest, LinkTimeOptimizationMissingFile) {
+  EXPECT_FALSE(driver_.RunCommand({"lto", "missing.bc"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("Could not open input file 'missing.bc'"));
+}
+
+TEST_F(DriverTest, LinkTimeOptimizationDuplicateDefinition) {
+  CreateTestFile("fn Helper() -> i32 { return 1; }", "a.carbon");
+  CreateTestFile("fn Helper() -> i32 { return 2; }", "b.carbon");
+  for (llvm::StringRef name : {"a", "b"}) {
+    EXPECT_TRUE(driver_.RunCommand({"compile", "--emit=llvm-bc", "--output=-",
+                                    (name + ".carbon").str()}));
+    EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+    fs_.addFile(
+        (name + ".bc").str(), /*ModificationTime=*/0,
+        llvm::MemoryBuffer::getMemBufferCopy(test_output_stream_.TakeStr()));
+  }
+
+  EXPECT_FALSE(driver_.RunCommand({"lto", "a.bc", "b.bc"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              AllOf(HasSubstr("Duplicate definition of symbol 'Helper'"),
+                    HasSubstr("b.bc"), HasSubstr("a.bc")));
+}
+
+TEST_F(DriverTest, LinkTimeOptimizationNegativeJobs) {
+  EXPECT_FALSE(driver_.RunCommand({"lto", "--jobs=-1", "missing.bc"}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("Requested a negative number of jobs: -1"));
+}
+
+TEST_F(DriverTest, ProfileGenerate) {
+  auto file =
+      CreateTestFile("fn F(b: bool) -> i32 { if (b) { return 1; } return 0; }");
+  EXPECT_TRUE(driver_.RunCommand({"compile", "--phase=lower", "--dump-llvm-ir",
+                                  "--profile-generate", file}));
+  auto ir = test_output_stream_.TakeStr();
+  EXPECT_THAT(ir, HasSubstr("@__profn_F"));
+  EXPECT_THAT(ir, HasSubstr("llvm.instrprof.increment.step"));
+}
+
+// Compiles `file` with instrumentation, and returns the structural hash of
+// function `name` from the `llvm.instrprof.increment` calls.
+static auto GetProfileHash(Driver& driver, TestRawOstream& output_stream,
+                           llvm::StringRef file, llvm::StringRef name)
+    -> uint64_t {
+  EXPECT_TRUE(driver.RunCommand({"compile", "--phase=lower", "--dump-llvm-ir",
+                                 "--profile-generate", file}));
+  llvm::SmallVector<llvm::StringRef> matches;
+  auto ir = output_stream.TakeStr();
+  EXPECT_TRUE(
+      llvm::Regex(("@__profn_" + name + ", i64 (-?[0-9]+),").str())
+          .match(ir, &matches))
+      << ir;
+  int64_t hash = 0;
+  EXPECT_FALSE(matches.size() < 2 || matches[1].getAsInteger(10, hash));
+  return hash;
+}
+
+// Writes an indexed profile containing `records` to `file_name`.
+static auto AddProfile(llvm::vfs::InMemoryFileSystem& fs,
+                       llvm::StringRef file_name,
+                       llvm::ArrayRef<llvm::NamedInstrProfRecord> records)
+    -> void {
+  llvm::InstrProfWriter writer;
+  for (auto record : records) {
+    writer.addRecord(std::move(record), [](llvm::Error error) {
+      ADD_FAILURE() << llvm::toString(std::move(error));
+    });
+  }
+  fs.addFile(file_name, /*ModificationTime=*/0, writer.writeBuffer());
+}
+
+TEST_F(DriverTest, ProfileUse) {
+  auto file =
+      CreateTestFile("fn F(b: bool) -> i32 { if (b) { return 1; } return 0; }");
+  uint64_t hash = GetProfileHash(driver_, test_output_stream_, file, "F");
+
+  // The counters are the entry count, then the number of times the branch is
+  // evaluated and the number of times it's taken.
+  AddProfile(fs_, "test.profdata",
+             {llvm::NamedInstrProfRecord("F", hash, {100, 100, 90})});
+  EXPECT_TRUE(driver_.RunCommand({"compile", "--phase=lower", "--dump-llvm-ir",
+                                  "--profile-use=test.profdata", file}));
+  EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+  auto ir = test_output_stream_.TakeStr();
+  EXPECT_THAT(ir, ContainsRegex(R"(define i32 @F\(i1 %b\) #0 !prof ![0-9]+)"));
+  EXPECT_THAT(ir, ContainsRegex(R"(br i1 %b, .*, !prof ![0-9]+)"));
+  EXPECT_THAT(ir, HasSubstr(R"(!{!"function_entry_count", i64 100})"));
+  EXPECT_THAT(ir, HasSubstr(R"(!{!"branch_weights", i32 91, i32 11})"));
+}
+
+TEST_F(DriverTest, ProfileUseStaleProfile) {
+  auto file =
+      CreateTestFile("fn F(b: bool) -> i32 { if (b) { return 1; } return 0; }");
+  uint64_t hash = GetProfileHash(driver_, test_output_stream_, file, "F");
+
+  // A profile collected from a different version of the function, or with a
+  // different number of counters, is ignored.
+  AddProfile(fs_, "stale.profdata",
+             {llvm::NamedInstrProfRecord("F", hash + 1, {100, 100, 90})});
+  AddProfile(fs_, "mismatched.profdata",
+             {llvm::NamedInstrProfRecord("F", hash, {100})});
+  for (llvm::StringRef profile : {"stale.profdata", "mismatched.profdata"}) {
+    SCOPED_TRACE(profile);
+    EXPECT_TRUE(driver_.RunCommand(
+        {"compile", "--phase=lower", "--dump-llvm-ir",
+         llvm::formatv("--profile-use={0}", profile).str(), file}));
+    EXPECT_THAT(test_error_stream_.TakeStr(), StrEq(""));
+    EXPECT_THAT(test_output_stream_.TakeStr(), Not(HasSubstr("!prof")));
+  }
+}
+
+TEST_F(DriverTest, ProfileUseInvalidFile) {
+  auto file = CreateTestFile("fn F() {}");
+  fs_.addFile("invalid.profdata", /*ModificationTime=*/0,
+              llvm::MemoryBuffer::getMemBuffer("not a profile"));
+  EXPECT_FALSE(driver_.RunCommand(
+      {"compile", "--phase=lower", "--profile-use=invalid.profdata", file}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("Could not read profile 'invalid.profdata'"));
+}
+
+TEST_F(DriverTest, ProfileUseMissingFile) {
+  auto file = CreateTestFile("fn F() {}");
+  EXPECT_FALSE(driver_.RunCommand(
+      {"compile", "--phase=lower", "--profile-use=missing.profdata", file}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("Could not read profile 'missing.profdata'"));
+}
+
+TEST_F(DriverTest, ProfileGenerateAndUse) {
+  auto file = CreateTestFile("fn F() {}");
+  EXPECT_FALSE(driver_.RunCommand({"compile", "--profile-generate",
+                                   "--profile-use=test.profdata", file}));
+  EXPECT_THAT(test_error_stream_.TakeStr(),
+              HasSubstr("both generating and using a profile"));
+}
+
 }  // namespace
 }  // namespace Carbon
@@ -0,0 +1,160 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/driver/unit_dependency_graph.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "common/check.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+
+namespace Carbon {
+
+auto GetPackageDirective(const Lex::TokenizedBuffer& tokens,
+                         const Parse::Tree& parse_tree)
+    -> std::optional<PackageDirective> {
+  // The directive must be the first thing in the file, so only its nodes are
+  // examined.
+  PackageDirective directive;
+  bool in_directive = false;
+  for (auto node : parse_tree.postorder()) {
+    switch (parse_tree.node_kind(node)) {
+      case Parse::NodeKind::FileStart:
+        break;
+      case Parse::NodeKind::PackageIntroducer:
+        in_directive = true;
+        break;
+      case Parse::NodeKind::Name:
+        if (!in_directive) {
+          return std::nullopt;
+        }
+        directive.package = tokens.GetIdentifierText(
+            tokens.GetIdentifier(parse_tree.node_token(node)));
+        break;
+      case Parse::NodeKind::Literal:
+        if (!in_directive) {
+          return std::nullopt;
+        }
+        directive.library =
+            tokens.GetStringLiteral(parse_tree.node_token(node));
+        break;
+      case Parse::NodeKind::PackageLibrary:
+      case Parse::NodeKind::PackageApi:
+        break;
+      case Parse::NodeKind::PackageImpl:
+        directive.is_impl = true;
+        break;
+      case Parse::NodeKind::PackageDirective:
+        if (parse_tree.node_has_error(node)) {
+          return std::nullopt;
+        }
+        return directive;
+      default:
+        return std::nullopt;
+    }
+  }
+  return std::nullopt;
+}
+
+UnitDependencyGraph::UnitDependencyGraph(
+    llvm::ArrayRef<std::optional<PackageDirective>> directives)
+    : dependencies_(directives.size()), dependents_(directives.size()) {
+  // Find the `api` files of each library.
+  llvm::DenseMap<std::pair<llvm::StringRef, llvm::StringRef>,
+                 llvm::SmallVector<int, 1>>
+      library_apis;
+  for (auto [unit, directive] : llvm::enumerate(directives)) {
+    if (directive && !directive->is_impl) {
+      library_apis[{directive->package, directive->library}].push_back(unit);
+    }
+  }
+
+  for (auto [unit, directive] : llvm::enumerate(directives)) {
+    if (!directive || !directive->is_impl) {
+      continue;
+    }
+    auto it = library_apis.find({directive->package, directive->library});
+    if (it == library_apis.end()) {
+      continue;
+    }
+    for (int api_unit : it->second) {
+      dependencies_[unit].push_back(api_unit);
+      dependents_[api_unit].push_back(unit);
+    }
+  }
+}
+
+auto UnitDependencyGraph::TopologicalOrder() const -> llvm::SmallVector<int> {
+  llvm::SmallVector<int> remaining_dependencies;
+  // Always picks the earliest ready unit, to keep input order where possible.
+  std::priority_queue<int, std::vector<int>, std::greater<>> ready;
+  for (int unit = 0; unit < size(); ++unit) {
+    remaining_dependencies.push_back(dependencies_[unit].size());
+    if (dependencies_[unit].empty()) {
+      ready.push(unit);
+    }
+  }
+
+  llvm::SmallVector<int> order;
+  while (!ready.empty()) {
+    int unit = ready.top();
+    ready.pop();
+    order.push_back(unit);
+    for (int dependent : dependents_[unit]) {
+      if (--remaining_dependencies[dependent] == 0) {
+        ready.push(dependent);
+      }
+    }
+  }
+  CARBON_CHECK(static_cast<int>(order.size()) == size())
+      << "Cycle in unit dependencies";
+  return order;
+}
+
+auto UnitDependencyGraph::RunInDependencyOrder(
+    int jobs, llvm::function_ref<void(int)> fn) const -> void {
+  if (jobs == 1 || size() <= 1) {
+    for (int unit : TopologicalOrder()) {
+      fn(unit);
+    }
+    return;
+  }
+
+  auto remaining_dependencies =
+      std::make_unique<std::atomic<int>[]>(size());
+  for (int unit = 0; unit < size(); ++unit) {
+    remaining_dependencies[unit] = dependencies_[unit].size();
+  }
+
+  // Each task starts its dependents once it's the last of their dependencies
+  // to finish. Tasks are queued before the task queueing them completes, so
+  // `wait` returns only once every unit has run.
+  llvm::ThreadPool pool(llvm::hardware_concurrency(jobs));
+  std::atomic<int> num_run = 0;
+  std::function<void(int)> run = [&](int unit) {
+    fn(unit);
+    ++num_run;
+    for (int dependent : dependents_[unit]) {
+      if (--remaining_dependencies[dependent] == 0) {
+        pool.async(run, dependent);
+      }
+    }
+  };
+  for (int unit = 0; unit < size(); ++unit) {
+    if (dependencies_[unit].empty()) {
+      pool.async(run, unit);
+    }
+  }
+  pool.wait();
+  CARBON_CHECK(num_run == size()) << "Cycle in unit dependencies";
+}
+
+}  // namespace Carbon
@@ -0,0 +1,75 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CARBON_TOOLCHAIN_DRIVER_UNIT_DEPENDENCY_GRAPH_H_
+#define CARBON_TOOLCHAIN_DRIVER_UNIT_DEPENDENCY_GRAPH_H_
+
+#include <optional>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "toolchain/lex/tokenized_buffer.h"
+#include "toolchain/parse/tree.h"
+
+namespace Carbon {
+
+// The library a file belongs to, as declared by its `package` directive.
+struct PackageDirective {
+  llvm::StringRef package;
+  // Empty for the default library of the package.
+  llvm::StringRef library;
+  bool is_impl = false;
+};
+
+// Returns the `package` directive of a parsed file, or nullopt if it doesn't
+// have a valid one. Strings refer to storage in `tokens`.
+auto GetPackageDirective(const Lex::TokenizedBuffer& tokens,
+                         const Parse::Tree& parse_tree)
+    -> std::optional<PackageDirective>;
+
+// Dependencies between the files, or units, of a compilation. Units are
+// identified by their index in the list of inputs.
+//
+// An `impl` file depends on the `api` files of its library.
+// TODO: Add edges for `import` directives once they're parsed.
+class UnitDependencyGraph {
+ public:
+  // Builds the graph for units with the given package directives.
+  explicit UnitDependencyGraph(
+      llvm::ArrayRef<std::optional<PackageDirective>> directives);
+
+  // Returns the number of units.
+  auto size() const -> int { return dependencies_.size(); }
+
+  // Returns the units that `unit` depends on.
+  auto dependencies(int unit) const -> llvm::ArrayRef<int> {
+    return dependencies_[unit];
+  }
+
+  // Returns the units that depend on `unit`.
+  auto dependents(int unit) const -> llvm::ArrayRef<int> {
+    return dependents_[unit];
+  }
+
+  // Returns the units ordered so that each follows its dependencies. Units that
+  // don't depend on each other stay in input order.
+  auto TopologicalOrder() const -> llvm::SmallVector<int>;
+
+  // Calls `fn` on every unit, each after it has been called on the unit's
+  // dependencies. With more than one job, units whose dependencies are done run
+  // concurrently, and `fn` must be safe to call from multiple threads. A `jobs`
+  // of 0 uses all available cores.
+  auto RunInDependencyOrder(int jobs, llvm::function_ref<void(int)> fn) const
+      -> void;
+
+ private:
+  llvm::SmallVector<llvm::SmallVector<int, 1>> dependencies_;
+  llvm::SmallVector<llvm::SmallVector<int, 1>> dependents_;
+};
+
+}  // namespace Carbon
+
+#endif  // CARBON_TOOLCHAIN_DRIVER_UNIT_DEPENDENCY_GRAPH_H_
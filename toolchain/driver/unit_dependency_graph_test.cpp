@@ -0,0 +1,68 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/driver/unit_dependency_graph.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace Carbon {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAre;
+
+TEST(UnitDependencyGraphTest, NoDirectives) {
+  UnitDependencyGraph graph({std::nullopt, std::nullopt, std::nullopt});
+  EXPECT_EQ(graph.size(), 3);
+  EXPECT_THAT(graph.dependencies(1), IsEmpty());
+  EXPECT_THAT(graph.TopologicalOrder(), ElementsAre(0, 1, 2));
+}
+
+TEST(UnitDependencyGraphTest, ImplDependsOnApi) {
+  UnitDependencyGraph graph({
+      PackageDirective{.package = "P", .library = "L", .is_impl = true},
+      PackageDirective{.package = "P", .library = "", .is_impl = true},
+      PackageDirective{.package = "Q", .library = "L", .is_impl = false},
+      PackageDirective{.package = "P", .library = "L", .is_impl = false},
+      std::nullopt,
+      PackageDirective{.package = "P", .library = "L", .is_impl = true},
+  });
+  EXPECT_THAT(graph.dependencies(0), ElementsAre(3));
+  // There's no API file for the default library of `P`.
+  EXPECT_THAT(graph.dependencies(1), IsEmpty());
+  EXPECT_THAT(graph.dependencies(2), IsEmpty());
+  EXPECT_THAT(graph.dependents(3), UnorderedElementsAre(0, 5));
+  EXPECT_THAT(graph.dependencies(5), ElementsAre(3));
+  EXPECT_THAT(graph.TopologicalOrder(), ElementsAre(1, 2, 3, 0, 4, 5));
+}
+
+TEST(UnitDependencyGraphTest, RunInDependencyOrder) {
+  std::vector<std::optional<PackageDirective>> directives;
+  for (int i = 0; i < 50; ++i) {
+    directives.push_back(
+        PackageDirective{.package = "P", .library = "L", .is_impl = i > 0});
+  }
+  UnitDependencyGraph graph(directives);
+
+  for (int jobs : {1, 4}) {
+    std::mutex mutex;
+    std::vector<int> order;
+    graph.RunInDependencyOrder(jobs, [&](int unit) {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(unit);
+    });
+    ASSERT_EQ(order.size(), directives.size());
+    // The API file must run first.
+    EXPECT_EQ(order.front(), 0);
+  }
+}
+
+}  // namespace
+}  // namespace Carbon
@@ -947,6 +947,11 @@ auto TokenizedBuffer::GetColumnNumber(Token token) const -> int {
   return GetTokenInfo(token).column + 1;
 }
 
+auto TokenizedBuffer::GetByteOffset(Token token) const -> int64_t {
+  const auto& token_info = GetTokenInfo(token);
+  return GetLineInfo(token_info.token_line).start + token_info.column;
+}
+
 auto TokenizedBuffer::GetTokenText(Token token) const -> llvm::StringRef {
   const auto& token_info = GetTokenInfo(token);
   llvm::StringRef fixed_spelling = token_info.kind.fixed_spelling();
@@ -183,6 +183,10 @@ class TokenizedBuffer : public Printable<TokenizedBuffer> {
   // Returns the 1-based column number.
   [[nodiscard]] auto GetColumnNumber(Token token) const -> int;
 
+  // Returns the zero-based byte offset of the start of the token within the
+  // source buffer.
+  [[nodiscard]] auto GetByteOffset(Token token) const -> int64_t;
+
   // Returns the source text lexed into this token.
   [[nodiscard]] auto GetTokenText(Token token) const -> llvm::StringRef;
 
@@ -0,0 +1,169 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/lower/abi.h"
+
+#include <algorithm>
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/TargetParser/Triple.h"
+
+namespace Carbon::Lower {
+
+namespace {
+// A scalar within an aggregate.
+struct Scalar {
+  uint64_t offset;
+  llvm::Type* type;
+};
+}  // namespace
+
+// Appends the scalars making up `type`, at `offset` within the outermost
+// aggregate, to `scalars`.
+static auto FlattenScalars(const llvm::DataLayout& layout, llvm::Type* type,
+                           uint64_t offset,
+                           llvm::SmallVectorImpl<Scalar>& scalars) -> void {
+  if (auto* struct_type = llvm::dyn_cast<llvm::StructType>(type)) {
+    const auto* struct_layout = layout.getStructLayout(struct_type);
+    for (unsigned i = 0; i < struct_type->getNumElements(); ++i) {
+      FlattenScalars(layout, struct_type->getElementType(i),
+                     offset + struct_layout->getElementOffset(i), scalars);
+    }
+  } else if (auto* array_type = llvm::dyn_cast<llvm::ArrayType>(type)) {
+    auto* element_type = array_type->getElementType();
+    uint64_t element_size = layout.getTypeAllocSize(element_type);
+    for (uint64_t i = 0; i < array_type->getNumElements(); ++i) {
+      FlattenScalars(layout, element_type, offset + i * element_size, scalars);
+    }
+  } else {
+    scalars.push_back({.offset = offset, .type = type});
+  }
+}
+
+// Returns the type of a homogeneous floating-point aggregate with the given
+// scalars, or null if they aren't all of the same floating-point type.
+static auto GetHomogeneousFloatingPointType(llvm::ArrayRef<Scalar> scalars)
+    -> llvm::Type* {
+  if (scalars.empty() || !scalars.front().type->isFloatingPointTy()) {
+    return nullptr;
+  }
+  auto* type = scalars.front().type;
+  if (!llvm::all_of(scalars, [&](Scalar s) { return s.type == type; })) {
+    return nullptr;
+  }
+  return type;
+}
+
+// Splits an aggregate of `size` bytes into eightbytes. When
+// `use_fp_registers` is set, an eightbyte whose scalars are all of the same
+// floating-point type uses that type, or a vector of it if there are several,
+// even if the scalars only cover part of the eightbyte. All others use an
+// integer covering its bytes.
+static auto GetEightbyteType(const llvm::DataLayout& layout,
+                             llvm::LLVMContext& context, uint64_t size,
+                             llvm::ArrayRef<Scalar> scalars,
+                             bool use_fp_registers) -> llvm::Type* {
+  llvm::SmallVector<llvm::Type*, 2> eightbytes;
+  for (uint64_t begin = 0; begin < size; begin += 8) {
+    uint64_t end = std::min(begin + 8, size);
+    llvm::SmallVector<Scalar, 2> covered;
+    for (auto scalar : scalars) {
+      if (scalar.offset >= begin && scalar.offset < end) {
+        covered.push_back(scalar);
+      }
+    }
+
+    llvm::Type* eightbyte_type = nullptr;
+    if (use_fp_registers) {
+      if (auto* fp_type = GetHomogeneousFloatingPointType(covered)) {
+        // The scalars must be packed from the start of the eightbyte, so that
+        // the register has the same layout as the memory it's loaded from.
+        uint64_t fp_size = layout.getTypeAllocSize(fp_type);
+        bool packed = fp_size * covered.size() <= end - begin;
+        for (auto [i, scalar] : llvm::enumerate(covered)) {
+          packed &= scalar.offset == begin + i * fp_size;
+        }
+        if (packed) {
+          eightbyte_type =
+              covered.size() == 1
+                  ? fp_type
+                  : llvm::FixedVectorType::get(fp_type, covered.size());
+        }
+      }
+    }
+    if (!eightbyte_type) {
+      eightbyte_type = llvm::IntegerType::get(context, (end - begin) * 8);
+    }
+    eightbytes.push_back(eightbyte_type);
+  }
+
+  if (eightbytes.size() == 1) {
+    return eightbytes.front();
+  }
+  return llvm::StructType::get(context, eightbytes);
+}
+
+auto AggregateAbi::ForTarget(llvm::StringRef target_triple) -> AggregateAbi {
+  llvm::Triple triple(target_triple);
+  switch (triple.getArch()) {
+    case llvm::Triple::x86_64:
+      return AggregateAbi(triple.isOSWindows() ? Kind::X86_64Win
+                                               : Kind::X86_64SysV);
+    case llvm::Triple::aarch64:
+      return AggregateAbi(Kind::AArch64);
+    default:
+      // TODO: Add rules for more targets.
+      return AggregateAbi(Kind::Memory);
+  }
+}
+
+auto AggregateAbi::GetRegisterType(const llvm::DataLayout& layout,
+                                   llvm::Type* type) const -> llvm::Type* {
+  if (kind_ == Kind::Memory) {
+    return nullptr;
+  }
+  uint64_t size = layout.getTypeAllocSize(type);
+  if (size == 0) {
+    return nullptr;
+  }
+
+  auto& context = type->getContext();
+  llvm::SmallVector<Scalar> scalars;
+  FlattenScalars(layout, type, /*offset=*/0, scalars);
+
+  switch (kind_) {
+    case Kind::Memory:
+      return nullptr;
+
+    case Kind::X86_64SysV:
+      if (size > 16) {
+        return nullptr;
+      }
+      return GetEightbyteType(layout, context, size, scalars,
+                              /*use_fp_registers=*/true);
+
+    case Kind::X86_64Win:
+      if (size != 1 && size != 2 && size != 4 && size != 8) {
+        return nullptr;
+      }
+      return llvm::IntegerType::get(context, size * 8);
+
+    case Kind::AArch64:
+      if (auto* fp_type = GetHomogeneousFloatingPointType(scalars);
+          fp_type && scalars.size() <= 4) {
+        return llvm::ArrayType::get(fp_type, scalars.size());
+      }
+      if (size > 16) {
+        return nullptr;
+      }
+      return GetEightbyteType(layout, context, size, scalars,
+                              /*use_fp_registers=*/false);
+  }
+  llvm_unreachable("Unknown aggregate ABI kind");
+}
+
+}  // namespace Carbon::Lower
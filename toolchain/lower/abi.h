@@ -0,0 +1,61 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CARBON_TOOLCHAIN_LOWER_ABI_H_
+#define CARBON_TOOLCHAIN_LOWER_ABI_H_
+
+#include <cstdint>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/IR/DataLayout.h"
+#include "llvm/IR/Type.h"
+
+namespace Carbon::Lower {
+
+// Describes which aggregates the target's C calling convention passes and
+// returns in registers, and which registers it uses for them. Lowering uses
+// this to pass small structs and tuples directly instead of through memory.
+class AggregateAbi {
+ public:
+  // Returns the conventions for `target_triple`. Targets without known rules
+  // pass all aggregates in memory.
+  static auto ForTarget(llvm::StringRef target_triple) -> AggregateAbi;
+
+  // Builds conventions that pass all aggregates in memory.
+  AggregateAbi() = default;
+
+  // Returns the type used to pass or return an object of type `type` in
+  // registers, or null if it's passed in memory. The result is either a
+  // scalar, or a struct or array whose elements are each loaded from the
+  // matching offset in the object.
+  auto GetRegisterType(const llvm::DataLayout& layout, llvm::Type* type) const
+      -> llvm::Type*;
+
+  // Returns whether any aggregates are passed in registers.
+  auto passes_in_registers() const -> bool { return kind_ != Kind::Memory; }
+
+ private:
+  enum class Kind : int8_t {
+    // All aggregates are passed in memory.
+    Memory,
+    // The System V x86-64 ABI: aggregates of up to 16 bytes are split into
+    // eightbytes, each passed in an integer or SSE register.
+    X86_64SysV,
+    // The Microsoft x64 ABI: aggregates of 1, 2, 4, or 8 bytes are passed in
+    // an integer register.
+    X86_64Win,
+    // The AAPCS64 ABI: homogeneous floating-point aggregates of up to four
+    // members are passed in floating-point registers, and other aggregates of
+    // up to 16 bytes in up to two integer registers.
+    AArch64,
+  };
+
+  explicit AggregateAbi(Kind kind) : kind_(kind) {}
+
+  Kind kind_ = Kind::Memory;
+};
+
+}  // namespace Carbon::Lower
+
+#endif  // CARBON_TOOLCHAIN_LOWER_ABI_H_
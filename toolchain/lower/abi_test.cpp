@@ -0,0 +1,102 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/lower/abi.h"
+
+#include <gtest/gtest.h>
+
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/LLVMContext.h"
+
+namespace Carbon::Lower {
+namespace {
+
+class AggregateAbiTest : public ::testing::Test {
+ protected:
+  // Returns the register type for `type` on x86-64 Linux, or null if it's
+  // passed in memory.
+  auto GetSysVRegisterType(llvm::Type* type) -> llvm::Type* {
+    return AggregateAbi::ForTarget("x86_64-unknown-linux-gnu")
+        .GetRegisterType(layout_, type);
+  }
+
+  // Returns the register type for `type` on AArch64 Linux, or null if it's
+  // passed in memory.
+  auto GetAArch64RegisterType(llvm::Type* type) -> llvm::Type* {
+    return AggregateAbi::ForTarget("aarch64-unknown-linux-gnu")
+        .GetRegisterType(aarch64_layout_, type);
+  }
+
+  auto Struct(llvm::ArrayRef<llvm::Type*> elements) -> llvm::StructType* {
+    return llvm::StructType::get(context_, elements);
+  }
+
+  llvm::LLVMContext context_;
+  llvm::DataLayout layout_ = llvm::DataLayout(
+      "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128");
+  llvm::DataLayout aarch64_layout_ =
+      llvm::DataLayout("e-m:e-i8:8:32-i16:16:32-i64:64-i128:128-n32:64-S128");
+  llvm::Type* f32_ = llvm::Type::getFloatTy(context_);
+  llvm::Type* f64_ = llvm::Type::getDoubleTy(context_);
+  llvm::Type* i32_ = llvm::Type::getInt32Ty(context_);
+  llvm::Type* i64_ = llvm::Type::getInt64Ty(context_);
+};
+
+TEST_F(AggregateAbiTest, SysVFullEightbytes) {
+  EXPECT_EQ(GetSysVRegisterType(Struct({f64_})), f64_);
+  EXPECT_EQ(GetSysVRegisterType(Struct({f64_, f64_})), Struct({f64_, f64_}));
+  EXPECT_EQ(GetSysVRegisterType(Struct({f32_, f32_})),
+            llvm::FixedVectorType::get(f32_, 2));
+  EXPECT_EQ(GetSysVRegisterType(Struct({f64_, i32_, i32_})),
+            Struct({f64_, i64_}));
+}
+
+TEST_F(AggregateAbiTest, SysVPartialEightbytes) {
+  EXPECT_EQ(GetSysVRegisterType(Struct({f32_})), f32_);
+  EXPECT_EQ(GetSysVRegisterType(Struct({f64_, f32_})), Struct({f64_, f32_}));
+  EXPECT_EQ(GetSysVRegisterType(Struct({f32_, f32_, f32_})),
+            Struct({llvm::FixedVectorType::get(f32_, 2), f32_}));
+  EXPECT_EQ(GetSysVRegisterType(Struct({i32_, f32_, f32_})),
+            Struct({i64_, f32_}));
+}
+
+TEST_F(AggregateAbiTest, SysVMixedEightbytes) {
+  // An eightbyte holding both integer and floating-point scalars uses an
+  // integer register.
+  EXPECT_EQ(GetSysVRegisterType(Struct({f32_, i32_})),
+            llvm::Type::getInt64Ty(context_));
+  EXPECT_EQ(GetSysVRegisterType(Struct({f64_, i32_})),
+            Struct({f64_, i64_}));
+  EXPECT_EQ(GetSysVRegisterType(Struct({f64_, f64_, f64_})), nullptr);
+}
+
+TEST_F(AggregateAbiTest, AArch64HomogeneousFloatingPointAggregates) {
+  auto* f64x2 = llvm::ArrayType::get(f64_, 2);
+  EXPECT_EQ(GetAArch64RegisterType(Struct({f64_})),
+            llvm::ArrayType::get(f64_, 1));
+  EXPECT_EQ(GetAArch64RegisterType(Struct({f64_, f64_})), f64x2);
+  EXPECT_EQ(GetAArch64RegisterType(Struct({f32_, f32_, f32_})),
+            llvm::ArrayType::get(f32_, 3));
+  // Nested aggregates are flattened.
+  EXPECT_EQ(GetAArch64RegisterType(Struct({Struct({f64_, f64_}), f64x2})),
+            llvm::ArrayType::get(f64_, 4));
+  // An HFA can be larger than 16 bytes, but has at most four members.
+  EXPECT_EQ(GetAArch64RegisterType(Struct({f64_, f64_, f64_, f64_})),
+            llvm::ArrayType::get(f64_, 4));
+  EXPECT_EQ(GetAArch64RegisterType(Struct({f64_, f64_, f64_, f64_, f64_})),
+            nullptr);
+}
+
+TEST_F(AggregateAbiTest, AArch64IntegerRegisters) {
+  // Mixed floating-point types aren't an HFA.
+  EXPECT_EQ(GetAArch64RegisterType(Struct({f32_, f64_})), Struct({i64_, i64_}));
+  EXPECT_EQ(GetAArch64RegisterType(Struct({f64_, i32_})), Struct({i64_, i64_}));
+  EXPECT_EQ(GetAArch64RegisterType(Struct({i32_, i32_})), i64_);
+  EXPECT_EQ(GetAArch64RegisterType(Struct({i32_, i32_, i32_})),
+            Struct({i64_, i32_}));
+  EXPECT_EQ(GetAArch64RegisterType(Struct({i64_, i64_, i32_})), nullptr);
+}
+
+}  // namespace
+}  // namespace Carbon::Lower
@@ -18,13 +18,28 @@ namespace Carbon::Lower {
 FileContext::FileContext(llvm::LLVMContext& llvm_context,
                          llvm::StringRef module_name,
                          const SemIR::File& semantics_ir,
+                         llvm::StringRef target_triple,
+                         const llvm::DataLayout* data_layout,
+                         const AggregateAbi& aggregate_abi,
+                         bool profile_generate,
+                         llvm::IndexedInstrProfReader* profile_reader,
                          llvm::raw_ostream* vlog_stream)
     : llvm_context_(&llvm_context),
       llvm_module_(std::make_unique<llvm::Module>(module_name, llvm_context)),
       semantics_ir_(&semantics_ir),
+      aggregate_abi_(aggregate_abi),
+      profile_generate_(profile_generate),
+      profile_reader_(profile_reader),
       vlog_stream_(vlog_stream) {
   CARBON_CHECK(!semantics_ir.has_errors())
       << "Generating LLVM IR from invalid SemIR::File is unsupported.";
+  // Sizes and alignments used while lowering, such as for passing aggregates
+  // in registers and for parameter attributes, come from the module's layout,
+  // so it must match the target before anything is lowered.
+  llvm_module_->setTargetTriple(target_triple);
+  if (data_layout) {
+    llvm_module_->setDataLayout(*data_layout);
+  }
 }
 
 // TODO: Move this to lower.cpp.
@@ -37,6 +52,12 @@ auto FileContext::Run() -> std::unique_ptr<llvm::Module> {
   for (auto [i, type] : llvm::enumerate(types)) {
     types_[i] = BuildType(type);
   }
+  if (aggregate_abi_.passes_in_registers()) {
+    register_types_.resize_for_overwrite(types.size());
+    for (auto i : llvm::seq(types.size())) {
+      register_types_[i] = BuildRegisterType(SemIR::TypeId(i));
+    }
+  }
 
   // Lower function declarations.
   functions_.resize_for_overwrite(semantics_ir_->functions_size());
@@ -70,17 +91,27 @@ auto FileContext::BuildFunctionDeclaration(SemIR::FunctionId function_id)
                 .kind = SemIR::InitializingRepresentation::None};
   CARBON_CHECK(return_rep.has_return_slot() == has_return_slot);
 
+  // A return value that fits in registers is returned directly, and the return
+  // slot is local to the function.
+  llvm::Type* return_register_type =
+      has_return_slot ? GetRegisterType(function.return_type_id) : nullptr;
+
   llvm::SmallVector<llvm::Type*> param_types;
   // TODO: Consider either storing `param_node_ids` somewhere so that we can
   // reuse it from `BuildFunctionDefinition` and when building calls, or factor
   // out a mechanism to compute the mapping between parameters and arguments on
   // demand.
   llvm::SmallVector<SemIR::NodeId> param_node_ids;
+  // For each parameter passed by pointer, the type of the pointee; null for
+  // other parameters.
+  llvm::SmallVector<llvm::Type*> param_pointee_types;
   param_types.reserve(has_return_slot + param_refs.size());
   param_node_ids.reserve(has_return_slot + param_refs.size());
-  if (has_return_slot) {
+  param_pointee_types.reserve(has_return_slot + param_refs.size());
+  if (has_return_slot && !return_register_type) {
     param_types.push_back(GetType(function.return_type_id)->getPointerTo());
     param_node_ids.push_back(function.return_slot_id);
+    param_pointee_types.push_back(nullptr);
   }
   for (auto param_ref_id : param_refs) {
     auto param_type_id = semantics_ir().GetNode(param_ref_id).type_id();
@@ -93,18 +124,29 @@ auto FileContext::BuildFunctionDeclaration(SemIR::FunctionId function_id)
       case SemIR::ValueRepresentation::Custom:
         param_types.push_back(GetType(value_rep.type));
         param_node_ids.push_back(param_ref_id);
+        param_pointee_types.push_back(nullptr);
         break;
-      case SemIR::ValueRepresentation::Pointer:
-        param_types.push_back(GetType(value_rep.type)->getPointerTo());
+      case SemIR::ValueRepresentation::Pointer: {
+        if (auto* register_type = GetRegisterType(param_type_id)) {
+          param_types.push_back(register_type);
+          param_node_ids.push_back(param_ref_id);
+          param_pointee_types.push_back(nullptr);
+          break;
+        }
+        auto* pointee_type = GetType(value_rep.type);
+        param_types.push_back(pointee_type->getPointerTo());
         param_node_ids.push_back(param_ref_id);
+        param_pointee_types.push_back(pointee_type);
         break;
+      }
     }
   }
 
   // If the initializing representation doesn't produce a value, set the return
   // type to void.
   llvm::Type* return_type =
-      return_rep.kind == SemIR::InitializingRepresentation::ByCopy
+      return_register_type ? return_register_type
+      : return_rep.kind == SemIR::InitializingRepresentation::ByCopy
           ? GetType(function.return_type_id)
           : llvm::Type::getVoidTy(llvm_context());
 
@@ -123,17 +165,34 @@ auto FileContext::BuildFunctionDeclaration(SemIR::FunctionId function_id)
       llvm::Function::Create(function_type, llvm::Function::ExternalLinkage,
                              mangled_name, llvm_module());
 
+  // Carbon has no unwinding, so no call can throw.
+  llvm_function->addFnAttr(llvm::Attribute::NoUnwind);
+
   // Set up parameters and the return slot.
-  for (auto [node_id, arg] :
-       llvm::zip_equal(param_node_ids, llvm_function->args())) {
+  const auto& data_layout = llvm_module().getDataLayout();
+  for (auto [node_id, pointee_type, arg] : llvm::zip_equal(
+           param_node_ids, param_pointee_types, llvm_function->args())) {
     if (node_id == function.return_slot_id) {
       arg.setName("return");
+      // The return slot is always a fresh object provided by the caller.
+      arg.addAttr(llvm::Attribute::NoAlias);
       arg.addAttr(llvm::Attribute::getWithStructRetType(
           llvm_context(), GetType(function.return_type_id)));
     } else {
       arg.setName(semantics_ir().GetString(
           semantics_ir().GetNode(node_id).GetAsParameter()));
     }
+    if (pointee_type) {
+      // A value passed by pointer points to a complete object that the callee
+      // can't modify. It's not `noalias`: the value may be a view of a
+      // variable that the callee modifies through a pointer parameter.
+      arg.addAttr(llvm::Attribute::NonNull);
+      arg.addAttr(llvm::Attribute::ReadOnly);
+      arg.addAttr(llvm::Attribute::getWithAlignment(
+          llvm_context(), data_layout.getABITypeAlign(pointee_type)));
+      arg.addAttr(llvm::Attribute::getWithDereferenceableBytes(
+          llvm_context(), data_layout.getTypeAllocSize(pointee_type)));
+    }
   }
 
   return llvm_function;
@@ -158,11 +217,25 @@ auto FileContext::BuildFunctionDefinition(SemIR::FunctionId function_id)
   // function parameters that was already computed in BuildFunctionDeclaration.
   // We should only do that once.
   auto param_refs = semantics_ir().GetNodeBlock(function.param_refs_id);
+  // Values passed in registers are spilled to memory in the entry block, so
+  // that they have the same representation as in the rest of the function.
+  function_lowering.builder().SetInsertPoint(
+      function_lowering.GetBlock(body_block_ids.front()));
+  if (profile_generate_ || profile_reader_) {
+    function_lowering.StartProfile(body_block_ids);
+  }
   int param_index = 0;
   if (has_return_slot) {
-    function_lowering.SetLocal(function.return_slot_id,
-                               llvm_function->getArg(param_index));
-    ++param_index;
+    if (llvm_function->getReturnType()->isVoidTy()) {
+      function_lowering.SetLocal(function.return_slot_id,
+                                 llvm_function->getArg(param_index));
+      ++param_index;
+    } else {
+      auto* return_slot = function_lowering.builder().CreateAlloca(
+          GetType(function.return_type_id), /*ArraySize=*/nullptr, "return");
+      function_lowering.SetLocal(function.return_slot_id, return_slot);
+      function_lowering.set_return_slot_storage(return_slot);
+    }
   }
   for (auto param_ref_id : param_refs) {
     auto param_type_id = semantics_ir().GetNode(param_ref_id).type_id();
@@ -170,6 +243,15 @@ auto FileContext::BuildFunctionDefinition(SemIR::FunctionId function_id)
         SemIR::ValueRepresentation::None) {
       function_lowering.SetLocal(
           param_ref_id, llvm::PoisonValue::get(GetType(param_type_id)));
+    } else if (GetRegisterType(param_type_id)) {
+      auto* arg = llvm_function->getArg(param_index);
+      auto* storage = function_lowering.builder().CreateAlloca(
+          GetType(param_type_id), /*ArraySize=*/nullptr,
+          arg->getName() + ".addr");
+      function_lowering.StoreFromRegisters(arg, GetType(param_type_id),
+                                           storage);
+      function_lowering.SetLocal(param_ref_id, storage);
+      ++param_index;
     } else {
       function_lowering.SetLocal(param_ref_id,
                                  llvm_function->getArg(param_index));
@@ -186,6 +268,46 @@ auto FileContext::BuildFunctionDefinition(SemIR::FunctionId function_id)
     function_lowering.builder().SetInsertPoint(llvm_block);
     function_lowering.LowerBlock(block_id);
   }
+  function_lowering.EmitLifetimeMarkers();
+}
+
+auto FileContext::BuildRegisterType(SemIR::TypeId type_id) -> llvm::Type* {
+  if (SemIR::GetValueRepresentation(semantics_ir(), type_id).kind !=
+      SemIR::ValueRepresentation::Pointer) {
+    return nullptr;
+  }
+
+  // Only structs and tuples are passed in registers. Arrays are always passed
+  // by pointer to support indexing, and an element with a pointer value
+  // representation is stored as a pointer rather than inline, so can't be
+  // loaded as part of the aggregate.
+  llvm::SmallVector<SemIR::TypeId> element_type_ids;
+  auto node = semantics_ir().GetNode(
+      semantics_ir().GetTypeAllowBuiltinTypes(type_id));
+  switch (node.kind()) {
+    case SemIR::NodeKind::StructType:
+      for (auto field_id :
+           semantics_ir().GetNodeBlock(node.GetAsStructType())) {
+        element_type_ids.push_back(
+            semantics_ir().GetNode(field_id).GetAsStructTypeField().second);
+      }
+      break;
+    case SemIR::NodeKind::TupleType:
+      llvm::append_range(element_type_ids,
+                         semantics_ir().GetTypeBlock(node.GetAsTupleType()));
+      break;
+    default:
+      return nullptr;
+  }
+  for (auto element_type_id : element_type_ids) {
+    if (SemIR::GetValueRepresentation(semantics_ir(), element_type_id).kind !=
+        SemIR::ValueRepresentation::Copy) {
+      return nullptr;
+    }
+  }
+
+  return aggregate_abi_.GetRegisterType(llvm_module().getDataLayout(),
+                                        GetType(type_id));
 }
 
 auto FileContext::BuildType(SemIR::NodeId node_id) -> llvm::Type* {
@@ -8,6 +8,8 @@
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/ProfileData/InstrProfReader.h"
+#include "toolchain/lower/abi.h"
 #include "toolchain/sem_ir/file.h"
 #include "toolchain/sem_ir/node.h"
 
@@ -19,6 +21,11 @@ class FileContext {
   explicit FileContext(llvm::LLVMContext& llvm_context,
                        llvm::StringRef module_name,
                        const SemIR::File& semantics_ir,
+                       llvm::StringRef target_triple,
+                       const llvm::DataLayout* data_layout,
+                       const AggregateAbi& aggregate_abi,
+                       bool profile_generate,
+                       llvm::IndexedInstrProfReader* profile_reader,
                        llvm::raw_ostream* vlog_stream);
 
   // Lowers the SemIR::File to LLVM IR. Should only be called once, and handles
@@ -41,6 +48,19 @@ class FileContext {
     return types_[type_id.index];
   }
 
+  // Returns the type used to pass a value of the given type in registers across
+  // a call boundary, or null if the value is passed in the same way as it is
+  // represented. Only types with a pointer value representation are passed in
+  // registers; these are loaded from and stored to memory at the call
+  // boundary.
+  auto GetRegisterType(SemIR::TypeId type_id) -> llvm::Type* {
+    if (type_id.index < 0 ||
+        static_cast<size_t>(type_id.index) >= register_types_.size()) {
+      return nullptr;
+    }
+    return register_types_[type_id.index];
+  }
+
   // Returns a lowered value to use for a value of type `type`.
   auto GetTypeAsValue() -> llvm::Value* {
     return llvm::ConstantStruct::get(GetTypeType());
@@ -49,6 +69,10 @@ class FileContext {
   auto llvm_context() -> llvm::LLVMContext& { return *llvm_context_; }
   auto llvm_module() -> llvm::Module& { return *llvm_module_; }
   auto semantics_ir() -> const SemIR::File& { return *semantics_ir_; }
+  auto profile_generate() const -> bool { return profile_generate_; }
+  auto profile_reader() -> llvm::IndexedInstrProfReader* {
+    return profile_reader_;
+  }
 
  private:
   // Builds the declaration for the given function, which should then be cached
@@ -64,6 +88,10 @@ class FileContext {
   // caller.
   auto BuildType(SemIR::NodeId node_id) -> llvm::Type*;
 
+  // Builds the register type for the given type, which should then be cached
+  // by the caller.
+  auto BuildRegisterType(SemIR::TypeId type_id) -> llvm::Type*;
+
   // Returns the empty LLVM struct type used to represent the type `type`.
   auto GetTypeType() -> llvm::StructType* {
     if (!type_type_) {
@@ -80,6 +108,15 @@ class FileContext {
   // The input SemIR.
   const SemIR::File* const semantics_ir_;
 
+  // The target's conventions for passing aggregates.
+  AggregateAbi aggregate_abi_;
+
+  // Whether to add profile instrumentation.
+  bool profile_generate_;
+
+  // Profile data used to annotate the IR, or null if there is none.
+  llvm::IndexedInstrProfReader* profile_reader_;
+
   // The optional vlog stream.
   llvm::raw_ostream* vlog_stream_;
 
@@ -90,6 +127,10 @@ class FileContext {
   // Provides lowered versions of types.
   llvm::SmallVector<llvm::Type*> types_;
 
+  // Provides the types used to pass values in registers, or null for types
+  // that aren't passed in registers. Empty if no types are.
+  llvm::SmallVector<llvm::Type*> register_types_;
+
   // Lowered version of the builtin type `type`.
   llvm::StructType* type_type_ = nullptr;
 };
@@ -4,7 +4,14 @@
 
 #include "toolchain/lower/function_context.h"
 
+#include <limits>
+
 #include "common/vlog.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/MDBuilder.h"
+#include "llvm/ProfileData/InstrProf.h"
+#include "llvm/Support/MD5.h"
 #include "toolchain/sem_ir/file.h"
 
 namespace Carbon::Lower {
@@ -78,6 +85,247 @@ auto FunctionContext::CreateSyntheticBlock() -> llvm::BasicBlock* {
   return synthetic_block_;
 }
 
+// Adds the kinds of the nodes in `block_id`, and in any blocks spliced into it,
+// to `hash`. Returns the number of `BranchIf` nodes found.
+static auto HashCodeBlock(const SemIR::File& semantics_ir,
+                          SemIR::NodeBlockId block_id, llvm::MD5& hash)
+    -> uint32_t {
+  uint32_t num_branches = 0;
+  for (auto node_id : semantics_ir.GetNodeBlock(block_id)) {
+    auto node = semantics_ir.GetNode(node_id);
+    hash.update(node.kind().name());
+    if (node.kind() == SemIR::NodeKind::BranchIf) {
+      ++num_branches;
+    } else if (node.kind() == SemIR::NodeKind::SpliceBlock) {
+      num_branches +=
+          HashCodeBlock(semantics_ir, node.GetAsSpliceBlock().first, hash);
+    }
+  }
+  return num_branches;
+}
+
+auto FunctionContext::StartProfile(
+    llvm::ArrayRef<SemIR::NodeBlockId> body_block_ids) -> void {
+  llvm::MD5 hash;
+  uint32_t num_branches = 0;
+  for (auto block_id : body_block_ids) {
+    num_branches += HashCodeBlock(semantics_ir(), block_id, hash);
+  }
+  llvm::MD5::MD5Result hash_result;
+  hash.final(hash_result);
+  profile_hash_ = hash_result.low();
+  num_profile_counters_ = 1 + 2 * num_branches;
+
+  if (file_context_->profile_generate()) {
+    profile_name_var_ =
+        llvm::createPGOFuncNameVar(*function_, function_->getName());
+    EmitProfileIncrement(0, /*step=*/nullptr);
+  }
+
+  if (auto* profile_reader = file_context_->profile_reader()) {
+    auto record = profile_reader->getInstrProfRecord(function_->getName(),
+                                                     profile_hash_);
+    if (!record) {
+      // Either the function never ran, or it has changed since the profile was
+      // collected.
+      CARBON_VLOG() << "No profile data for " << function_->getName() << ": "
+                    << llvm::toString(record.takeError()) << "\n";
+    } else if (record->Counts.size() == num_profile_counters_) {
+      profile_counts_ = std::move(record->Counts);
+      function_->setEntryCount(profile_counts_[0]);
+    }
+  }
+}
+
+auto FunctionContext::ProfileBranch(llvm::Value* cond) -> llvm::MDNode* {
+  if (num_profile_counters_ == 0) {
+    return nullptr;
+  }
+  uint32_t index = next_profile_counter_;
+  next_profile_counter_ += 2;
+  CARBON_CHECK(index + 1 < num_profile_counters_)
+      << "More branches lowered than counted";
+
+  if (profile_name_var_) {
+    EmitProfileIncrement(index, /*step=*/nullptr);
+    EmitProfileIncrement(index + 1,
+                         builder().CreateZExt(cond, builder().getInt64Ty()));
+  }
+
+  if (profile_counts_.empty()) {
+    return nullptr;
+  }
+  uint64_t evaluated = profile_counts_[index];
+  uint64_t taken = std::min(profile_counts_[index + 1], evaluated);
+  // Branch weights are 32-bit, so scale down large counts. Adding one keeps
+  // a branch direction that was never seen from being treated as impossible.
+  uint64_t scale = evaluated / std::numeric_limits<uint32_t>::max() + 1;
+  return llvm::MDBuilder(llvm_context())
+      .createBranchWeights(taken / scale + 1, (evaluated - taken) / scale + 1);
+}
+
+auto FunctionContext::EmitProfileIncrement(uint32_t index, llvm::Value* step)
+    -> void {
+  llvm::SmallVector<llvm::Value*, 5> args = {
+      profile_name_var_, builder().getInt64(profile_hash_),
+      builder().getInt32(num_profile_counters_), builder().getInt32(index)};
+  auto intrinsic_id = llvm::Intrinsic::instrprof_increment;
+  if (step) {
+    args.push_back(step);
+    intrinsic_id = llvm::Intrinsic::instrprof_increment_step;
+  }
+  builder().CreateCall(
+      llvm::Intrinsic::getDeclaration(&llvm_module(), intrinsic_id), args);
+}
+
+// Returns the number of registers in an aggregate register type, which is
+// either a struct of registers or an array of identical registers.
+static auto GetNumRegisters(llvm::Type* register_type) -> unsigned {
+  if (auto* array_type = llvm::dyn_cast<llvm::ArrayType>(register_type)) {
+    return array_type->getNumElements();
+  }
+  return register_type->getStructNumElements();
+}
+
+// Returns the alignment of register `i` of an aggregate register type, when
+// loaded from or stored to an object with alignment `object_align`.
+static auto GetRegisterAlign(const llvm::DataLayout& layout,
+                             llvm::Type* register_type, unsigned i,
+                             llvm::Align object_align) -> llvm::Align {
+  uint64_t offset;
+  if (auto* struct_type = llvm::dyn_cast<llvm::StructType>(register_type)) {
+    offset = layout.getStructLayout(struct_type)->getElementOffset(i);
+  } else {
+    offset = i * layout.getTypeAllocSize(register_type->getArrayElementType());
+  }
+  return llvm::commonAlignment(object_align, offset);
+}
+
+auto FunctionContext::LoadAsRegisters(llvm::Type* object_type,
+                                      llvm::Value* ptr,
+                                      llvm::Type* register_type)
+    -> llvm::Value* {
+  // The registers are loaded from the object, so can only assume its
+  // alignment, which may be less than that of the register type.
+  const auto& layout = llvm_module().getDataLayout();
+  auto object_align = layout.getABITypeAlign(object_type);
+  if (!register_type->isAggregateType()) {
+    return builder().CreateAlignedLoad(register_type, ptr, object_align);
+  }
+  // Load each register separately. Loading the whole register type could read
+  // past the end of the object, because the last register may be only
+  // partially used.
+  llvm::Value* value = llvm::PoisonValue::get(register_type);
+  for (unsigned i = 0; i < GetNumRegisters(register_type); ++i) {
+    auto* element_ptr =
+        builder().CreateConstInBoundsGEP2_32(register_type, ptr, 0, i);
+    auto* element = builder().CreateAlignedLoad(
+        llvm::GetElementPtrInst::getTypeAtIndex(register_type, i), element_ptr,
+        GetRegisterAlign(layout, register_type, i, object_align));
+    value = builder().CreateInsertValue(value, element, i);
+  }
+  return value;
+}
+
+auto FunctionContext::StoreFromRegisters(llvm::Value* value,
+                                         llvm::Type* object_type,
+                                         llvm::Value* ptr) -> void {
+  const auto& layout = llvm_module().getDataLayout();
+  auto object_align = layout.getABITypeAlign(object_type);
+  auto* register_type = value->getType();
+  if (!register_type->isAggregateType()) {
+    builder().CreateAlignedStore(value, ptr, object_align);
+    return;
+  }
+  for (unsigned i = 0; i < GetNumRegisters(register_type); ++i) {
+    auto* element_ptr =
+        builder().CreateConstInBoundsGEP2_32(register_type, ptr, 0, i);
+    builder().CreateAlignedStore(
+        builder().CreateExtractValue(value, i), element_ptr,
+        GetRegisterAlign(layout, register_type, i, object_align));
+  }
+}
+
+auto FunctionContext::CreateLocalStorage(llvm::Type* type,
+                                         const llvm::Twine& name)
+    -> llvm::AllocaInst* {
+  auto* alloca = builder().CreateAlloca(type, /*ArraySize=*/nullptr, name);
+  auto size = llvm_module().getDataLayout().getTypeAllocSize(type);
+  if (!size.isZero()) {
+    // The start marker is created now, so that it's the first use of the
+    // storage. The end marker is created by `EmitLifetimeMarkers`.
+    auto* start = builder().CreateLifetimeStart(
+        alloca, builder().getInt64(size.getFixedValue()));
+    local_storage_.push_back({alloca, start});
+  }
+  return alloca;
+}
+
+// Returns the last instruction other than its `start` marker that uses
+// `alloca`, directly or through a derived pointer. Returns null if `alloca` is
+// otherwise unused, is used outside the block that contains it, or may escape.
+// A pointer passed to a call is only treated as not escaping when it's the
+// return slot or a value parameter, because neither can be retained by the
+// callee.
+static auto FindLastUse(llvm::AllocaInst* alloca, llvm::CallInst* start)
+    -> llvm::Instruction* {
+  llvm::Instruction* last_use = nullptr;
+  llvm::SmallVector<llvm::Instruction*> worklist = {alloca};
+  while (!worklist.empty()) {
+    auto* ptr = worklist.pop_back_val();
+    for (auto& use : ptr->uses()) {
+      auto* user = llvm::cast<llvm::Instruction>(use.getUser());
+      if (user == start) {
+        continue;
+      }
+      if (user->getParent() != alloca->getParent()) {
+        return nullptr;
+      }
+      if (llvm::isa<llvm::GetElementPtrInst>(user)) {
+        worklist.push_back(user);
+      } else if (auto* store = llvm::dyn_cast<llvm::StoreInst>(user)) {
+        if (store->getValueOperand() == ptr) {
+          return nullptr;
+        }
+      } else if (auto* call = llvm::dyn_cast<llvm::CallInst>(user)) {
+        if (!llvm::isa<llvm::MemIntrinsic>(call) &&
+            !(call->isArgOperand(&use) &&
+              (call->paramHasAttr(call->getArgOperandNo(&use),
+                                  llvm::Attribute::StructRet) ||
+               call->paramHasAttr(call->getArgOperandNo(&use),
+                                  llvm::Attribute::ReadOnly)))) {
+          return nullptr;
+        }
+      } else if (!llvm::isa<llvm::LoadInst>(user)) {
+        return nullptr;
+      }
+      if (!last_use || last_use->comesBefore(user)) {
+        last_use = user;
+      }
+    }
+  }
+  return last_use;
+}
+
+auto FunctionContext::EmitLifetimeMarkers() -> void {
+  for (auto [alloca, start] : local_storage_) {
+    // TODO: Once SemIR records where scopes and full expressions end, use
+    // that to place the end marker instead, so that storage used in more than
+    // one block is also covered.
+    if (auto* last_use = FindLastUse(alloca, start)) {
+      llvm::IRBuilder<> end_builder(last_use->getNextNode());
+      end_builder.CreateLifetimeEnd(
+          alloca, llvm::cast<llvm::ConstantInt>(start->getArgOperand(0)));
+      continue;
+    }
+    auto* start_function = start->getCalledFunction();
+    start->eraseFromParent();
+    if (start_function->use_empty()) {
+      start_function->eraseFromParent();
+    }
+  }
+}
+
 auto FunctionContext::FinishInitialization(SemIR::TypeId type_id,
                                            SemIR::NodeId dest_id,
                                            SemIR::NodeId source_id) -> void {
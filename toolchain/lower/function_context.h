@@ -5,8 +5,12 @@
 #ifndef CARBON_TOOLCHAIN_LOWER_FUNCTION_CONTEXT_H_
 #define CARBON_TOOLCHAIN_LOWER_FUNCTION_CONTEXT_H_
 
+#include <vector>
+
+#include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Metadata.h"
 #include "llvm/IR/Module.h"
 #include "toolchain/lower/file_context.h"
 #include "toolchain/sem_ir/file.h"
@@ -67,11 +71,40 @@ class FunctionContext {
     return file_context_->GetType(type_id);
   }
 
+  // Returns the type used to pass a value of the given type in registers, or
+  // null if it's not passed in registers.
+  auto GetRegisterType(SemIR::TypeId type_id) -> llvm::Type* {
+    return file_context_->GetRegisterType(type_id);
+  }
+
   // Returns a lowered value to use for a value of type `type`.
   auto GetTypeAsValue() -> llvm::Value* {
     return file_context_->GetTypeAsValue();
   }
 
+  // Sets up profiling for a function whose body is `body_block_ids`. When
+  // instrumenting, this counts entries to the function, so should be called
+  // with the insertion point at the start of the function. When using profile
+  // data, this sets the function's entry count.
+  auto StartProfile(llvm::ArrayRef<SemIR::NodeBlockId> body_block_ids) -> void;
+
+  // Profiles a conditional branch on `cond` that is being lowered from a
+  // `BranchIf`. When instrumenting, this counts how often the branch is
+  // evaluated and taken. Returns the branch weights from profile data, or null
+  // if there are none.
+  auto ProfileBranch(llvm::Value* cond) -> llvm::MDNode*;
+
+  // Loads the object of type `object_type` at `ptr` as a value of type
+  // `register_type`, as returned by `GetRegisterType`, for passing in
+  // registers.
+  auto LoadAsRegisters(llvm::Type* object_type, llvm::Value* ptr,
+                       llvm::Type* register_type) -> llvm::Value*;
+
+  // Stores `value`, which was passed in registers, into the object of type
+  // `object_type` at `ptr`. This is the inverse of `LoadAsRegisters`.
+  auto StoreFromRegisters(llvm::Value* value, llvm::Type* object_type,
+                          llvm::Value* ptr) -> void;
+
   // Create a synthetic block that corresponds to no SemIR::NodeBlockId. Such
   // a block should only ever have a single predecessor, and is used when we
   // need multiple `llvm::BasicBlock`s to model the linear control flow in a
@@ -90,6 +123,16 @@ class FunctionContext {
   auto FinishInitialization(SemIR::TypeId type_id, SemIR::NodeId dest_id,
                             SemIR::NodeId init_id) -> void;
 
+  // Creates storage for a variable or temporary of the given type at the
+  // current insertion point, and starts its lifetime.
+  auto CreateLocalStorage(llvm::Type* type, const llvm::Twine& name)
+      -> llvm::AllocaInst*;
+
+  // Ends the lifetime of each storage created by `CreateLocalStorage` after
+  // its last use, or removes its start marker if the end of its lifetime
+  // can't be determined. Must be called once all blocks have been lowered.
+  auto EmitLifetimeMarkers() -> void;
+
   auto llvm_context() -> llvm::LLVMContext& {
     return file_context_->llvm_context();
   }
@@ -99,6 +142,13 @@ class FunctionContext {
     return file_context_->semantics_ir();
   }
 
+  // The storage for the return slot, if the function returns its result in
+  // registers rather than through a return slot provided by the caller.
+  auto return_slot_storage() -> llvm::Value* { return return_slot_storage_; }
+  auto set_return_slot_storage(llvm::Value* storage) -> void {
+    return_slot_storage_ = storage;
+  }
+
  private:
   // Emits a value copy for type `type_id` from `source_id` to `dest_id`.
   // `source_id` must produce a value representation for `type_id`, and
@@ -106,6 +156,10 @@ class FunctionContext {
   auto CopyValue(SemIR::TypeId type_id, SemIR::NodeId source_id,
                  SemIR::NodeId dest_id) -> void;
 
+  // Emits an increment of the profile counter `index` by `step`, or by one if
+  // `step` is null.
+  auto EmitProfileIncrement(uint32_t index, llvm::Value* step) -> void;
+
   // Context for the overall lowering process.
   FileContext* file_context_;
 
@@ -124,6 +178,26 @@ class FunctionContext {
   // such block.
   llvm::BasicBlock* synthetic_block_ = nullptr;
 
+  // The function-local return slot, or null if there isn't one.
+  llvm::Value* return_slot_storage_ = nullptr;
+
+  // Storage for variables and temporaries, in creation order, paired with its
+  // `llvm.lifetime.start` marker.
+  llvm::SmallVector<std::pair<llvm::AllocaInst*, llvm::CallInst*>>
+      local_storage_;
+
+  // Profiling state. Counter 0 counts entries to the function, and each
+  // `BranchIf`, in lowering order, has a pair of counters: the number of times
+  // it's evaluated, and the number of times it's taken. The hash identifies the
+  // structure of the function, so that stale profile data is ignored.
+  uint64_t profile_hash_ = 0;
+  uint32_t num_profile_counters_ = 0;
+  uint32_t next_profile_counter_ = 1;
+  // The PGO function name variable, if instrumenting.
+  llvm::GlobalVariable* profile_name_var_ = nullptr;
+  // The counters from profile data, if available.
+  std::vector<uint64_t> profile_counts_;
+
   // Maps a function's SemIR::File nodes to lowered values.
   // TODO: Handle nested scopes. Right now this is just cleared at the end of
   // every block.
@@ -100,7 +100,8 @@ auto HandleBranchIf(FunctionContext& context, SemIR::NodeId /*node_id*/,
   llvm::Value* cond = context.GetLocal(cond_id);
   llvm::BasicBlock* then_block = context.GetBlock(target_block_id);
   llvm::BasicBlock* else_block = context.CreateSyntheticBlock();
-  context.builder().CreateCondBr(cond, then_block, else_block);
+  context.builder().CreateCondBr(cond, then_block, else_block,
+                                 context.ProfileBranch(cond));
   context.builder().SetInsertPoint(else_block);
 }
 
@@ -146,20 +147,42 @@ auto HandleCall(FunctionContext& context, SemIR::NodeId node_id,
   llvm::ArrayRef<SemIR::NodeId> arg_ids =
       context.semantics_ir().GetNodeBlock(refs_id);
 
+  // If the function returns its result in registers, the caller still provides
+  // the return slot, and stores the result into it after the call.
+  llvm::Value* return_slot = nullptr;
   if (function.return_slot_id.is_valid()) {
-    args.push_back(context.GetLocal(arg_ids.back()));
+    return_slot = context.GetLocal(arg_ids.back());
     arg_ids = arg_ids.drop_back();
+    if (llvm_function->getReturnType()->isVoidTy()) {
+      args.push_back(return_slot);
+      return_slot = nullptr;
+    }
   }
 
   for (auto ref_id : arg_ids) {
     auto arg_type_id = context.semantics_ir().GetNode(ref_id).type_id();
     if (SemIR::GetValueRepresentation(context.semantics_ir(), arg_type_id)
-            .kind != SemIR::ValueRepresentation::None) {
+            .kind == SemIR::ValueRepresentation::None) {
+      continue;
+    }
+    if (auto* register_type = context.GetRegisterType(arg_type_id)) {
+      args.push_back(context.LoadAsRegisters(context.GetType(arg_type_id),
+                                             context.GetLocal(ref_id),
+                                             register_type));
+    } else {
       args.push_back(context.GetLocal(ref_id));
     }
   }
 
-  if (llvm_function->getReturnType()->isVoidTy()) {
+  if (return_slot) {
+    context.StoreFromRegisters(
+        context.builder().CreateCall(llvm_function, args,
+                                     llvm_function->getName()),
+        context.GetType(node.type_id()), return_slot);
+    // As with a void return type, the value of the call shouldn't be used.
+    context.SetLocal(node_id,
+                     llvm::PoisonValue::get(context.GetType(node.type_id())));
+  } else if (llvm_function->getReturnType()->isVoidTy()) {
     context.builder().CreateCall(llvm_function, args);
     // The value of a function call with a void return type shouldn't used, but
     // StubReference needs a value to propagate.
@@ -257,10 +280,21 @@ auto HandleReturnExpression(FunctionContext& context, SemIR::NodeId /*node_id*/,
               context.semantics_ir().GetNode(expr_id).type_id())
               .kind) {
     case SemIR::InitializingRepresentation::None:
-    case SemIR::InitializingRepresentation::InPlace:
       // Nothing to return.
       context.builder().CreateRetVoid();
       return;
+    case SemIR::InitializingRepresentation::InPlace:
+      if (auto* return_slot = context.return_slot_storage()) {
+        // The return slot is local, and its contents are returned in
+        // registers.
+        context.builder().CreateRet(context.LoadAsRegisters(
+            context.GetType(context.semantics_ir().GetNode(expr_id).type_id()),
+            return_slot, context.builder().getCurrentFunctionReturnType()));
+      } else {
+        // The result has already been stored in the caller's return slot.
+        context.builder().CreateRetVoid();
+      }
+      return;
     case SemIR::InitializingRepresentation::ByCopy:
       // The expression produces the value representation for the type.
       context.builder().CreateRet(context.GetLocal(expr_id));
@@ -504,9 +538,8 @@ auto HandleVarStorage(FunctionContext& context, SemIR::NodeId node_id,
   // something like `var` as a default. However, that's not possible right now
   // so cannot be tested.
   auto name = context.semantics_ir().GetString(node.GetAsVarStorage());
-  auto* alloca = context.builder().CreateAlloca(context.GetType(node.type_id()),
-                                                /*ArraySize=*/nullptr, name);
-  context.SetLocal(node_id, alloca);
+  context.SetLocal(node_id, context.CreateLocalStorage(
+                                context.GetType(node.type_id()), name));
 }
 
 }  // namespace Carbon::Lower
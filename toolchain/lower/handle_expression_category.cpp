@@ -41,9 +41,8 @@ auto HandleTemporary(FunctionContext& context, SemIR::NodeId node_id,
 
 auto HandleTemporaryStorage(FunctionContext& context, SemIR::NodeId node_id,
                             SemIR::Node node) -> void {
-  context.SetLocal(
-      node_id, context.builder().CreateAlloca(context.GetType(node.type_id()),
-                                              nullptr, "temp"));
+  context.SetLocal(node_id, context.CreateLocalStorage(
+                                context.GetType(node.type_id()), "temp"));
 }
 
 auto HandleValueAsReference(FunctionContext& context, SemIR::NodeId node_id,
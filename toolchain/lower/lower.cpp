@@ -9,10 +9,13 @@
 namespace Carbon::Lower {
 
 auto LowerToLLVM(llvm::LLVMContext& llvm_context, llvm::StringRef module_name,
-                 const SemIR::File& semantics_ir,
+                 const SemIR::File& semantics_ir, const LowerOptions& options,
                  llvm::raw_ostream* vlog_stream)
     -> std::unique_ptr<llvm::Module> {
-  FileContext context(llvm_context, module_name, semantics_ir, vlog_stream);
+  FileContext context(llvm_context, module_name, semantics_ir,
+                      options.target_triple, options.data_layout,
+                      options.aggregate_abi, options.profile_generate,
+                      options.profile_reader, vlog_stream);
   return context.Run();
 }
 
@@ -5,15 +5,39 @@
 #ifndef CARBON_TOOLCHAIN_LOWER_LOWER_H_
 #define CARBON_TOOLCHAIN_LOWER_LOWER_H_
 
+#include "llvm/IR/DataLayout.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/ProfileData/InstrProfReader.h"
+#include "toolchain/lower/abi.h"
 #include "toolchain/sem_ir/file.h"
 
 namespace Carbon::Lower {
 
+// Options for lowering.
+struct LowerOptions {
+  // The target triple to record in the module.
+  llvm::StringRef target_triple;
+
+  // The data layout for `target_triple`. If null, LLVM's default layout is
+  // used, which may not match the sizes and alignments used by codegen.
+  const llvm::DataLayout* data_layout = nullptr;
+
+  // How small aggregates are passed and returned in registers.
+  AggregateAbi aggregate_abi;
+
+  // Whether to instrument functions and branches to collect an execution
+  // profile.
+  bool profile_generate = false;
+
+  // If set, profile data collected from an instrumented build, which is used to
+  // attach branch weights and function entry counts.
+  llvm::IndexedInstrProfReader* profile_reader = nullptr;
+};
+
 // Lowers SemIR to LLVM IR.
 auto LowerToLLVM(llvm::LLVMContext& llvm_context, llvm::StringRef module_name,
-                 const SemIR::File& semantics_ir,
+                 const SemIR::File& semantics_ir, const LowerOptions& options,
                  llvm::raw_ostream* vlog_stream)
     -> std::unique_ptr<llvm::Module>;
 
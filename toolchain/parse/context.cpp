@@ -58,21 +58,13 @@ Context::Context(Tree& tree, Lex::TokenizedBuffer& tokens,
 
 auto Context::AddLeafNode(NodeKind kind, Lex::Token token, bool has_error)
     -> void {
-  tree_->node_impls_.push_back(
-      Tree::NodeImpl(kind, has_error, token, /*subtree_size=*/1));
-  if (has_error) {
-    tree_->has_errors_ = true;
-  }
+  tree_->AddNodeImpl(kind, has_error, token, /*subtree_size=*/1);
 }
 
 auto Context::AddNode(NodeKind kind, Lex::Token token, int subtree_start,
                       bool has_error) -> void {
   int subtree_size = tree_->size() - subtree_start + 1;
-  tree_->node_impls_.push_back(
-      Tree::NodeImpl(kind, has_error, token, subtree_size));
-  if (has_error) {
-    tree_->has_errors_ = true;
-  }
+  tree_->AddNodeImpl(kind, has_error, token, subtree_size);
 }
 
 auto Context::ConsumeAndAddOpenParen(Lex::Token default_token,
@@ -147,27 +139,100 @@ auto Context::ConsumeIfPatternKeyword(Lex::TokenKind keyword_token,
   }
 }
 
+// Returns true if the token kind is likely to start a new declaration. Used
+// to bound error recovery within a declaration.
+static auto IsDeclarationIntroducer(Lex::TokenKind kind) -> bool {
+  return kind.IsOneOf({Lex::TokenKind::Class, Lex::TokenKind::Constraint,
+                       Lex::TokenKind::Fn, Lex::TokenKind::Interface,
+                       Lex::TokenKind::Let, Lex::TokenKind::Namespace,
+                       Lex::TokenKind::Package, Lex::TokenKind::Var});
+}
+
+// Returns true if error recovery may need to stop at a token of the given
+// kind, regardless of where it is.
+static auto IsRecoveryStop(Lex::TokenKind kind) -> bool {
+  return kind.is_closing_symbol() || IsDeclarationIntroducer(kind) ||
+         kind.IsOneOf({Lex::TokenKind::Colon, Lex::TokenKind::Comma,
+                       Lex::TokenKind::EndOfFile, Lex::TokenKind::Equal,
+                       Lex::TokenKind::In, Lex::TokenKind::Semi});
+}
+
+auto Context::ComputeRecoveryStops() -> void {
+  recovery_stops_.resize(tokens().size(), Lex::Token(Lex::Token::InvalidIndex));
+
+  // Walk backwards so that the stops after each token are known when we reach
+  // it. `next` is the token after the current one at the same level. On
+  // reaching a closing symbol, we enter a new level, which ends at that symbol,
+  // so save the enclosing level's `next` until we reach the matching opening
+  // symbol. The lexer guarantees that groups are balanced.
+  std::optional<Lex::Token> next;
+  llvm::SmallVector<std::optional<Lex::Token>> enclosing_nexts;
+  for (auto it = tokens().tokens().end(); it != tokens().tokens().begin();) {
+    Lex::Token token = *--it;
+    Lex::TokenKind kind = tokens().GetKind(token);
+    if (kind.is_closing_symbol()) {
+      // Recovery never steps past a closing symbol using the index.
+      enclosing_nexts.push_back(next);
+      next = token;
+      continue;
+    }
+    if (kind.is_opening_symbol()) {
+      next = enclosing_nexts.pop_back_val();
+    }
+    if (next) {
+      recovery_stops_[token.index] =
+          IsRecoveryStop(tokens().GetKind(*next)) ||
+                  tokens().GetLine(*next) != tokens().GetLine(token)
+              ? *next
+              : recovery_stops_[next->index];
+    }
+    next = token;
+  }
+}
+
+auto Context::NextRecoveryStop(Lex::Token token) -> Lex::Token {
+  if (recovery_stops_.empty()) {
+    ComputeRecoveryStops();
+  }
+  Lex::Token stop = recovery_stops_[token.index];
+  CARBON_CHECK(stop.is_valid())
+      << "No recovery stop after token " << token.index;
+  return stop;
+}
+
 auto Context::FindNextOf(std::initializer_list<Lex::TokenKind> desired_kinds)
     -> std::optional<Lex::Token> {
-  auto new_position = position_;
+  // Tokens of the desired kinds must be stops, so that none are skipped.
+  CARBON_DCHECK(llvm::all_of(desired_kinds, IsRecoveryStop))
+      << "FindNextOf can't search for every kind of token";
+  Lex::Token token = *position_;
   while (true) {
-    Lex::Token token = *new_position;
     Lex::TokenKind kind = tokens().GetKind(token);
     if (kind.IsOneOf(desired_kinds)) {
       return token;
     }
-
-    // Step to the next token at the current bracketing level.
     if (kind.is_closing_symbol() || kind == Lex::TokenKind::EndOfFile) {
       // There are no more tokens at this level.
       return std::nullopt;
-    } else if (kind.is_opening_symbol()) {
-      new_position = Lex::TokenIterator(tokens().GetMatchedClosingToken(token));
-      // Advance past the closing token.
-      ++new_position;
-    } else {
-      ++new_position;
     }
+    token = NextRecoveryStop(token);
+  }
+}
+
+auto Context::FindNextOfInDeclaration(
+    std::initializer_list<Lex::TokenKind> desired_kinds)
+    -> std::optional<Lex::Token> {
+  Lex::Token token = *position_;
+  while (true) {
+    Lex::TokenKind kind = tokens().GetKind(token);
+    if (kind.IsOneOf(desired_kinds)) {
+      return token;
+    }
+    if (kind.is_closing_symbol() || kind == Lex::TokenKind::EndOfFile ||
+        kind == Lex::TokenKind::Semi || IsDeclarationIntroducer(kind)) {
+      return std::nullopt;
+    }
+    token = NextRecoveryStop(token);
   }
 }
 
@@ -201,6 +266,7 @@ auto Context::SkipPastLikelyEnd(Lex::Token skip_root)
     return tokens().GetIndentColumnNumber(l) > root_line_indent;
   };
 
+  bool first_step = true;
   do {
     if (PositionIs(Lex::TokenKind::CloseCurlyBrace)) {
       // Immediately bail out if we hit an unmatched close curly, this will
@@ -214,13 +280,23 @@ auto Context::SkipPastLikelyEnd(Lex::Token skip_root)
       return semi;
     }
 
-    // Skip over any matching group of tokens().
-    if (SkipMatchingGroup()) {
-      continue;
+    if (PositionKind().is_closing_symbol()) {
+      // Step out of the current group.
+      ++position_;
+    } else if (first_step) {
+      // Skip over any matching group of tokens, or else step forward one
+      // token. The starting position's line may not pass the check below, so
+      // we must examine the next token even if it's on the same line.
+      if (!SkipMatchingGroup()) {
+        ++position_;
+      }
+    } else {
+      // Skip to the next semicolon, closing symbol, or token on a new line at
+      // this level. The tokens skipped are all on the same line as the
+      // current position, which passed the check below.
+      position_ = Lex::TokenIterator(NextRecoveryStop(*position_));
     }
-
-    // Otherwise just step forward one token.
-    ++position_;
+    first_step = false;
   } while (position_ != end_ &&
            is_same_line_or_indent_greater_than_root(*position_));
 
@@ -137,10 +137,19 @@ class Context {
   auto ConsumeIf(Lex::TokenKind kind) -> std::optional<Lex::Token>;
 
   // Find the next token of any of the given kinds at the current bracketing
-  // level.
+  // level. The kinds must be recovery stops; see `IsRecoveryStop`.
   auto FindNextOf(std::initializer_list<Lex::TokenKind> desired_kinds)
       -> std::optional<Lex::Token>;
 
+  // Like `FindNextOf`, but also stops at the likely end of the current
+  // declaration: a semicolon, a declaration introducer, or the end of the
+  // current bracketing level. This is used to recover from errors within a
+  // declaration, and bounds the search so that repeatedly failing declarations
+  // don't each scan the remainder of the file.
+  auto FindNextOfInDeclaration(
+      std::initializer_list<Lex::TokenKind> desired_kinds)
+      -> std::optional<Lex::Token>;
+
   // If the token is an opening symbol for a matched group, skips to the matched
   // closing symbol and returns true. Otherwise, returns false.
   auto SkipMatchingGroup() -> bool;
@@ -302,6 +311,13 @@ class Context {
   }
 
  private:
+  // Computes `recovery_stops_`.
+  auto ComputeRecoveryStops() -> void;
+
+  // Returns the token after `token` at the same bracketing level which is a
+  // recovery stop.
+  auto NextRecoveryStop(Lex::Token token) -> Lex::Token;
+
   // Prints a single token for a stack dump. Used by PrintForStackDump.
   auto PrintTokenForStackDump(llvm::raw_ostream& output, Lex::Token token) const
       -> void;
@@ -319,6 +335,13 @@ class Context {
   Lex::TokenIterator end_;
 
   llvm::SmallVector<StateStackEntry> state_stack_;
+
+  // For each token, the next token at the same bracketing level which error
+  // recovery may need to stop at: a token of a kind that recovery searches for,
+  // the closing symbol of the level, or the first token at the level on a new
+  // line. Recovery steps from stop to stop rather than token by token. This is
+  // only needed for error recovery, so it's computed on first use.
+  llvm::SmallVector<Lex::Token> recovery_stops_;
 };
 
 // `clang-format` has a bug with spacing around `->` returns in macros. See
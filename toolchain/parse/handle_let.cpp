@@ -23,8 +23,8 @@ auto HandleLetAfterPattern(Context& context) -> void {
   auto state = context.PopState();
 
   if (state.has_error) {
-    if (auto after_pattern =
-            context.FindNextOf({Lex::TokenKind::Equal, Lex::TokenKind::Semi})) {
+    if (auto after_pattern = context.FindNextOfInDeclaration(
+            {Lex::TokenKind::Equal, Lex::TokenKind::Semi})) {
       context.SkipTo(*after_pattern);
     }
   }
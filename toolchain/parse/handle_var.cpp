@@ -32,8 +32,8 @@ auto HandleVarAfterPattern(Context& context) -> void {
   auto state = context.PopState();
 
   if (state.has_error) {
-    if (auto after_pattern =
-            context.FindNextOf({Lex::TokenKind::Equal, Lex::TokenKind::Semi})) {
+    if (auto after_pattern = context.FindNextOfInDeclaration(
+            {Lex::TokenKind::Equal, Lex::TokenKind::Semi})) {
       context.SkipTo(*after_pattern);
     }
   }
@@ -20,6 +20,9 @@ class State : public CARBON_ENUM_BASE(State) {
  public:
 #define CARBON_PARSE_STATE(Name) CARBON_ENUM_CONSTANT_DECLARATION(Name)
 #include "toolchain/parse/state.def"
+
+  // Support conversion to an integer for table-based dispatch in the parser.
+  using EnumBase::AsInt;
 };
 
 #define CARBON_PARSE_STATE(Name) CARBON_ENUM_CONSTANT_DEFINITION(State, Name)
@@ -8,6 +8,7 @@
 #include "common/error.h"
 #include "llvm/ADT/Sequence.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Compiler.h"
 #include "toolchain/base/pretty_stack_trace_function.h"
 #include "toolchain/lex/tokenized_buffer.h"
 #include "toolchain/parse/context.h"
@@ -15,6 +16,45 @@
 
 namespace Carbon::Parse {
 
+using DispatchFunctionT = auto(Context& context) -> void;
+
+static auto DispatchNext(Context& context) -> void;
+
+// Wraps a state handler so that, once it returns, dispatch continues with a
+// must-tail call to `DispatchNext`. These are distinct named functions so that
+// they show up helpfully in profiles and backtraces, but all of them share
+// exactly the same signature so that they can form a single dispatch table.
+template <DispatchFunctionT* Handler>
+static auto Dispatch(Context& context) -> void {
+  Handler(context);
+  [[clang::musttail]] return DispatchNext(context);
+}
+
+// A table of dispatch functions indexed by `State`. This replaces a `switch`
+// over every state with a single indirect branch per handled state, using the
+// same technique as the lexer's table-based dispatch. See
+// `TokenizedBuffer::Lexer::MakeDispatchTable` for more on the rationale.
+static constexpr DispatchFunctionT* DispatchTable[] = {
+#define CARBON_PARSE_STATE(Name) &Dispatch<&Handle##Name>,
+#include "toolchain/parse/state.def"
+};
+
+// Continues the dispatch chain based on the state at the top of the stack.
+// Because this is a must-tail return, it cannot fail to tail-call and will not
+// grow the stack; this is in essence the parser's loop with dynamic tail
+// dispatch to the next handler.
+static auto DispatchNext(Context& context) -> void {
+  // When the state stack is empty, stop recursing. We hint this so that the
+  // tail-dispatch is optimized as that's essentially the loop back-edge and
+  // this is the loop exit.
+  if (LLVM_UNLIKELY(context.state_stack().empty())) {
+    return;
+  }
+  [[clang::musttail]] return DispatchTable[context.state_stack()
+                                               .back()
+                                               .state.AsInt()](context);
+}
+
 auto Tree::Parse(Lex::TokenizedBuffer& tokens, DiagnosticConsumer& consumer,
                  llvm::raw_ostream* vlog_stream) -> Tree {
   Lex::TokenLocationTranslator translator(&tokens);
@@ -37,17 +77,9 @@ auto Tree::Parse(Lex::TokenizedBuffer& tokens, DiagnosticConsumer& consumer,
     context.PushState(State::Package);
   }
 
-  while (!context.state_stack().empty()) {
-    // clang warns on unhandled enum values; clang-tidy is incorrect here.
-    // NOLINTNEXTLINE(bugprone-switch-missing-default-case)
-    switch (context.state_stack().back().state) {
-#define CARBON_PARSE_STATE(Name) \
-  case State::Name:              \
-    Handle##Name(context);       \
-    break;
-#include "toolchain/parse/state.def"
-    }
-  }
+  // Manually enter the dispatch loop. This call will tail-recurse through the
+  // dispatch table until the state stack is empty.
+  DispatchNext(context);
 
   context.AddLeafNode(NodeKind::FileEnd, *context.position());
 
@@ -62,7 +94,7 @@ auto Tree::Parse(Lex::TokenizedBuffer& tokens, DiagnosticConsumer& consumer,
 
 auto Tree::postorder() const -> llvm::iterator_range<PostorderIterator> {
   return {PostorderIterator(Node(0)),
-          PostorderIterator(Node(node_impls_.size()))};
+          PostorderIterator(Node(size()))};
 }
 
 auto Tree::postorder(Node n) const -> llvm::iterator_range<PostorderIterator> {
@@ -70,52 +102,50 @@ auto Tree::postorder(Node n) const -> llvm::iterator_range<PostorderIterator> {
   // The postorder ends after this node, the root, and begins at the start of
   // its subtree.
   int end_index = n.index + 1;
-  int start_index = end_index - node_impls_[n.index].subtree_size;
+  int start_index = end_index - subtree_size_at(n.index);
   return {PostorderIterator(Node(start_index)),
           PostorderIterator(Node(end_index))};
 }
 
 auto Tree::children(Node n) const -> llvm::iterator_range<SiblingIterator> {
   CARBON_CHECK(n.is_valid());
-  int end_index = n.index - node_impls_[n.index].subtree_size;
+  int end_index = n.index - subtree_size_at(n.index);
   return {SiblingIterator(*this, Node(n.index - 1)),
           SiblingIterator(*this, Node(end_index))};
 }
 
 auto Tree::roots() const -> llvm::iterator_range<SiblingIterator> {
-  return {
-      SiblingIterator(*this, Node(static_cast<int>(node_impls_.size()) - 1)),
-      SiblingIterator(*this, Node(-1))};
+  return {SiblingIterator(*this, Node(size() - 1)),
+          SiblingIterator(*this, Node(-1))};
 }
 
 auto Tree::node_has_error(Node n) const -> bool {
   CARBON_CHECK(n.is_valid());
-  return node_impls_[n.index].has_error;
+  return node_subtree_sizes_[n.index] < 0;
 }
 
 auto Tree::node_kind(Node n) const -> NodeKind {
   CARBON_CHECK(n.is_valid());
-  return node_impls_[n.index].kind;
+  return node_kinds_[n.index];
 }
 
 auto Tree::node_token(Node n) const -> Lex::Token {
   CARBON_CHECK(n.is_valid());
-  return node_impls_[n.index].token;
+  return node_tokens_[n.index];
 }
 
 auto Tree::node_subtree_size(Node n) const -> int32_t {
   CARBON_CHECK(n.is_valid());
-  return node_impls_[n.index].subtree_size;
+  return subtree_size_at(n.index);
 }
 
 auto Tree::GetNodeText(Node n) const -> llvm::StringRef {
   CARBON_CHECK(n.is_valid());
-  return tokens_->GetTokenText(node_impls_[n.index].token);
+  return tokens_->GetTokenText(node_tokens_[n.index]);
 }
 
 auto Tree::PrintNode(llvm::raw_ostream& output, Node n, int depth,
                      bool preorder) const -> bool {
-  const auto& n_impl = node_impls_[n.index];
   output.indent(2 * (depth + 2));
   output << "{";
   // If children are being added, include node_index in order to disambiguate
@@ -123,15 +153,15 @@ auto Tree::PrintNode(llvm::raw_ostream& output, Node n, int depth,
   if (preorder) {
     output << "node_index: " << n << ", ";
   }
-  output << "kind: '" << n_impl.kind << "', text: '"
-         << tokens_->GetTokenText(n_impl.token) << "'";
+  output << "kind: '" << node_kinds_[n.index] << "', text: '"
+         << tokens_->GetTokenText(node_tokens_[n.index]) << "'";
 
-  if (n_impl.has_error) {
+  if (node_has_error(n)) {
     output << ", has_error: yes";
   }
 
-  if (n_impl.subtree_size > 1) {
-    output << ", subtree_size: " << n_impl.subtree_size;
+  if (int32_t subtree_size = subtree_size_at(n.index); subtree_size > 1) {
+    output << ", subtree_size: " << subtree_size;
     if (preorder) {
       output << ", children: [\n";
       return true;
@@ -224,72 +254,67 @@ auto Tree::Verify() const -> ErrorOr<Success> {
   llvm::SmallVector<Node> nodes;
   // Traverse the tree in postorder.
   for (Node n : postorder()) {
-    const auto& n_impl = node_impls_[n.index];
+    NodeKind kind = node_kinds_[n.index];
 
-    if (n_impl.has_error && !has_errors_) {
+    if (node_has_error(n) && !has_errors_) {
       return Error(llvm::formatv(
           "Node #{0} has errors, but the tree is not marked as having any.",
           n.index));
     }
 
     int subtree_size = 1;
-    if (n_impl.kind.has_bracket()) {
+    if (kind.has_bracket()) {
       while (true) {
         if (nodes.empty()) {
           return Error(
               llvm::formatv("Node #{0} is a {1} with bracket {2}, but didn't "
                             "find the bracket.",
-                            n, n_impl.kind, n_impl.kind.bracket()));
+                            n, kind, kind.bracket()));
         }
-        auto child_impl = node_impls_[nodes.pop_back_val().index];
-        subtree_size += child_impl.subtree_size;
-        if (n_impl.kind.bracket() == child_impl.kind) {
+        int32_t child_index = nodes.pop_back_val().index;
+        subtree_size += subtree_size_at(child_index);
+        if (kind.bracket() == node_kinds_[child_index]) {
           break;
         }
       }
     } else {
-      for (int i : llvm::seq(n_impl.kind.child_count())) {
+      for (int i : llvm::seq(kind.child_count())) {
         if (nodes.empty()) {
           return Error(llvm::formatv(
               "Node #{0} is a {1} with child_count {2}, but only had {3} "
               "nodes to consume.",
-              n, n_impl.kind, n_impl.kind.child_count(), i));
+              n, kind, kind.child_count(), i));
         }
-        auto child_impl = node_impls_[nodes.pop_back_val().index];
-        subtree_size += child_impl.subtree_size;
+        subtree_size += subtree_size_at(nodes.pop_back_val().index);
       }
     }
-    if (n_impl.subtree_size != subtree_size) {
+    if (subtree_size_at(n.index) != subtree_size) {
       return Error(llvm::formatv(
           "Node #{0} is a {1} with subtree_size of {2}, but calculated {3}.", n,
-          n_impl.kind, n_impl.subtree_size, subtree_size));
+          kind, subtree_size_at(n.index), subtree_size));
     }
     nodes.push_back(n);
   }
 
   // Remaining nodes should all be roots in the tree; make sure they line up.
-  CARBON_CHECK(nodes.back().index ==
-               static_cast<int32_t>(node_impls_.size()) - 1)
-      << nodes.back() << " " << node_impls_.size() - 1;
+  CARBON_CHECK(nodes.back().index == size() - 1)
+      << nodes.back() << " " << size() - 1;
   int prev_index = -1;
   for (const auto& n : nodes) {
-    const auto& n_impl = node_impls_[n.index];
-
-    if (n.index - n_impl.subtree_size != prev_index) {
-      return Error(
-          llvm::formatv("Node #{0} is a root {1} with subtree_size {2}, but "
-                        "previous root was at #{3}.",
-                        n, n_impl.kind, n_impl.subtree_size, prev_index));
+    if (n.index - subtree_size_at(n.index) != prev_index) {
+      return Error(llvm::formatv(
+          "Node #{0} is a root {1} with subtree_size {2}, but "
+          "previous root was at #{3}.",
+          n, node_kinds_[n.index], subtree_size_at(n.index), prev_index));
     }
     prev_index = n.index;
   }
 
-  if (!has_errors_ && static_cast<int32_t>(node_impls_.size()) !=
-                          tokens_->expected_parse_tree_size()) {
+  if (!has_errors_ && size() != tokens_->expected_parse_tree_size()) {
     return Error(
         llvm::formatv("Tree has {0} nodes and no errors, but "
                       "Lex::TokenizedBuffer expected {1} nodes for {2} tokens.",
-                      node_impls_.size(), tokens_->expected_parse_tree_size(),
+                      size(), tokens_->expected_parse_tree_size(),
                       tokens_->size()));
   }
   return Success();
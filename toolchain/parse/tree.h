@@ -5,6 +5,8 @@
 #ifndef CARBON_TOOLCHAIN_PARSE_TREE_H_
 #define CARBON_TOOLCHAIN_PARSE_TREE_H_
 
+#include <cstdint>
+#include <cstdlib>
 #include <iterator>
 
 #include "common/error.h"
@@ -72,7 +74,7 @@ class Tree : public Printable<Tree> {
   [[nodiscard]] auto has_errors() const -> bool { return has_errors_; }
 
   // Returns the number of nodes in this parse tree.
-  [[nodiscard]] auto size() const -> int { return node_impls_.size(); }
+  [[nodiscard]] auto size() const -> int { return node_kinds_.size(); }
 
   // Returns an iterable range over the parse tree nodes in depth-first
   // postorder.
@@ -167,65 +169,30 @@ class Tree : public Printable<Tree> {
  private:
   friend class Context;
 
-  // The in-memory representation of data used for a particular node in the
-  // tree.
-  struct NodeImpl {
-    explicit NodeImpl(NodeKind kind, bool has_error, Lex::Token token,
-                      int subtree_size)
-        : kind(kind),
-          has_error(has_error),
-          token(token),
-          subtree_size(subtree_size) {}
-
-    // The kind of this node. Note that this is only a single byte.
-    NodeKind kind;
-
-    // We have 3 bytes of padding here that we can pack flags or other compact
-    // data into.
-
-    // Whether this node is or contains a parse error.
-    //
-    // When this is true, this node and its children may not have the expected
-    // grammatical production structure. Prior to reasoning about any specific
-    // subtree structure, this flag must be checked.
-    //
-    // Not every node in the path from the root to an error will have this field
-    // set to true. However, any node structure that fails to conform to the
-    // expected grammatical production will be contained within a subtree with
-    // this flag set. Whether parents of that subtree also have it set is
-    // optional (and will depend on the particular parse implementation
-    // strategy). The goal is that you can rely on grammar-based structural
-    // invariants *until* you encounter a node with this set.
-    bool has_error = false;
-
-    // The token root of this node.
-    Lex::Token token;
-
-    // The size of this node's subtree of the parse tree. This is the number of
-    // nodes (and thus tokens) that are covered by this node (and its
-    // descendents) in the parse tree.
-    //
-    // During a *reverse* postorder (RPO) traversal of the parse tree, this can
-    // also be thought of as the offset to the next non-descendant node. When
-    // this node is not the first child of its parent (which is the last child
-    // visited in RPO), that is the offset to the next sibling. When this node
-    // *is* the first child of its parent, this will be an offset to the node's
-    // parent's next sibling, or if it the parent is also a first child, the
-    // grandparent's next sibling, and so on.
-    //
-    // This field should always be a positive integer as at least this node is
-    // part of its subtree.
-    int32_t subtree_size;
-  };
-
-  static_assert(sizeof(NodeImpl) == 12,
-                "Unexpected size of node implementation!");
-
   // Wires up the reference to the tokenized buffer. The `Parse` function should
   // be used to actually parse the tokens into a tree.
   explicit Tree(Lex::TokenizedBuffer& tokens_arg) : tokens_(&tokens_arg) {
     // If the tree is valid, there will be one node per token, so reserve once.
-    node_impls_.reserve(tokens_->expected_parse_tree_size());
+    int expected_size = tokens_->expected_parse_tree_size();
+    node_kinds_.reserve(expected_size);
+    node_tokens_.reserve(expected_size);
+    node_subtree_sizes_.reserve(expected_size);
+  }
+
+  // Appends a node in postorder. Used by `Context` while parsing.
+  auto AddNodeImpl(NodeKind kind, bool has_error, Lex::Token token,
+                   int32_t subtree_size) -> void {
+    node_kinds_.push_back(kind);
+    node_tokens_.push_back(token);
+    node_subtree_sizes_.push_back(has_error ? -subtree_size : subtree_size);
+    if (has_error) {
+      has_errors_ = true;
+    }
+  }
+
+  // Returns the subtree size of a node, removing the error bit.
+  auto subtree_size_at(int32_t index) const -> int32_t {
+    return std::abs(node_subtree_sizes_[index]);
   }
 
   // Prints a single node for Print(). Returns true when preorder and there are
@@ -233,8 +200,46 @@ class Tree : public Printable<Tree> {
   auto PrintNode(llvm::raw_ostream& output, Node n, int depth,
                  bool preorder) const -> bool;
 
-  // Depth-first postorder sequence of node implementation data.
-  llvm::SmallVector<NodeImpl> node_impls_;
+  // The data for each node is stored as a structure of arrays, with each array
+  // in depth-first postorder. This keeps the arrays densely packed, so that
+  // passes which only look at some of the data, such as walking `node_kind`
+  // in postorder, only touch the memory they need. It also avoids padding: a
+  // node takes 9 bytes rather than the 12 of an equivalent struct.
+
+  // The kind of each node. Note that this is only a single byte.
+  llvm::SmallVector<NodeKind> node_kinds_;
+
+  // The token root of each node.
+  llvm::SmallVector<Lex::Token> node_tokens_;
+
+  // The size of each node's subtree of the parse tree. This is the number of
+  // nodes (and thus tokens) that are covered by this node (and its
+  // descendents) in the parse tree.
+  //
+  // During a *reverse* postorder (RPO) traversal of the parse tree, this can
+  // also be thought of as the offset to the next non-descendant node. When
+  // this node is not the first child of its parent (which is the last child
+  // visited in RPO), that is the offset to the next sibling. When this node
+  // *is* the first child of its parent, this will be an offset to the node's
+  // parent's next sibling, or if it the parent is also a first child, the
+  // grandparent's next sibling, and so on.
+  //
+  // The magnitude is always a positive integer as at least this node is part
+  // of its subtree. The sign holds whether this node is or contains a parse
+  // error, with a negative size indicating an error.
+  //
+  // When a node has an error, this node and its children may not have the
+  // expected grammatical production structure. Prior to reasoning about any
+  // specific subtree structure, this flag must be checked.
+  //
+  // Not every node in the path from the root to an error will have this flag
+  // set. However, any node structure that fails to conform to the expected
+  // grammatical production will be contained within a subtree with this flag
+  // set. Whether parents of that subtree also have it set is optional (and will
+  // depend on the particular parse implementation strategy). The goal is that
+  // you can rely on grammar-based structural invariants *until* you encounter a
+  // node with this set.
+  llvm::SmallVector<int32_t> node_subtree_sizes_;
 
   Lex::TokenizedBuffer* tokens_;
 
@@ -324,7 +329,7 @@ class Tree::SiblingIterator
 
   using iterator_facade_base::operator++;
   auto operator++() -> SiblingIterator& {
-    node_.index -= std::abs(tree_->node_impls_[node_.index].subtree_size);
+    node_.index -= tree_->subtree_size_at(node_.index);
     return *this;
   }
 
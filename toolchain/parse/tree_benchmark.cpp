@@ -0,0 +1,138 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "common/check.h"
+#include "llvm/ADT/Sequence.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "toolchain/diagnostics/diagnostic_emitter.h"
+#include "toolchain/diagnostics/null_diagnostics.h"
+#include "toolchain/lex/tokenized_buffer.h"
+#include "toolchain/parse/node_kind.h"
+#include "toolchain/parse/tree.h"
+
+namespace Carbon::Parse {
+namespace {
+
+// Builds a source file with `num_functions` copies of a function exercising a
+// representative mix of declarations, statements, and expressions, so that the
+// parser visits a broad set of states.
+auto MakeFunctionsSource(int num_functions) -> std::string {
+  std::string source;
+  llvm::raw_string_ostream out(source);
+  for (int i : llvm::seq(num_functions)) {
+    out << llvm::formatv(R"(
+fn F{0}(a: i32, b: (i32, i32), c: {{.x: i32, .y: i32}) -> i32 {{
+  var n: i32 = a * 2 + b[0] - c.x;
+  let m: i32 = (n + 1) * (c.y - 3);
+  var arr: [i32; 4] = (1, 2, 3, 4);
+  while (n < m and not (n == 10)) {{
+    if (n > arr[1]) {{
+      n = n - 1;
+    } else {{
+      n = n + G{0}(n, &arr[2]);
+      break;
+    }
+  }
+  return if n > 0 then n else -m;
+}
+)",
+                         i);
+  }
+  return source;
+}
+
+class ParserBenchHelper {
+ public:
+  explicit ParserBenchHelper(llvm::StringRef text)
+      : source_(MakeSourceBuffer(text)),
+        tokens_(Lex::TokenizedBuffer::Lex(source_, NullDiagnosticConsumer())) {
+    CARBON_CHECK(!tokens_.has_errors());
+  }
+
+  auto Parse() -> Tree {
+    return Tree::Parse(tokens_, NullDiagnosticConsumer(),
+                       /*vlog_stream=*/nullptr);
+  }
+
+  auto num_tokens() const -> int { return tokens_.size(); }
+
+ private:
+  auto MakeSourceBuffer(llvm::StringRef text) -> SourceBuffer {
+    CARBON_CHECK(fs_.addFile(filename_, /*ModificationTime=*/0,
+                             llvm::MemoryBuffer::getMemBuffer(text)));
+    return std::move(*SourceBuffer::CreateFromFile(
+        fs_, filename_, ConsoleDiagnosticConsumer()));
+  }
+
+  llvm::vfs::InMemoryFileSystem fs_;
+  std::string filename_ = "test.carbon";
+  SourceBuffer source_;
+  Lex::TokenizedBuffer tokens_;
+};
+
+// Measures parse throughput, excluding lexing. Tree verification is included,
+// as it is part of every `Tree::Parse` call.
+void BM_ParseFunctions(benchmark::State& state) {
+  ParserBenchHelper helper(MakeFunctionsSource(state.range(0)));
+  int num_nodes = 0;
+  for (auto _ : state) {
+    Tree tree = helper.Parse();
+    CARBON_CHECK(!tree.has_errors());
+    num_nodes = tree.size();
+  }
+
+  state.counters["tokens_per_second"] = benchmark::Counter(
+      helper.num_tokens(), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["nodes_per_second"] = benchmark::Counter(
+      num_nodes, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_ParseFunctions)->Arg(10)->Arg(100)->Arg(1000);
+
+// Measures a postorder walk that reads each node's kind and error state, as
+// checking does. This depends only on how the tree stores its nodes.
+void BM_PostorderWalk(benchmark::State& state) {
+  ParserBenchHelper helper(MakeFunctionsSource(state.range(0)));
+  Tree tree = helper.Parse();
+  CARBON_CHECK(!tree.has_errors());
+  for (auto _ : state) {
+    int num_names = 0;
+    for (Node n : tree.postorder()) {
+      num_names += tree.node_kind(n) == NodeKind::Name;
+      num_names += tree.node_has_error(n);
+    }
+    benchmark::DoNotOptimize(num_names);
+  }
+
+  state.counters["nodes_per_second"] = benchmark::Counter(
+      tree.size(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_PostorderWalk)->Arg(10)->Arg(100)->Arg(1000);
+
+// Measures parse throughput on broken input, where each declaration fails and
+// goes through error recovery. This is derived from fuzzer inputs that
+// previously made recovery scan the remainder of the file for each failing
+// declaration. The per-token rate should stay flat as the size grows.
+void BM_ParseBrokenDeclarations(benchmark::State& state) {
+  std::string source;
+  for (int i : llvm::seq(state.range(0))) {
+    static_cast<void>(i);
+    source += "var * x\n";
+  }
+  ParserBenchHelper helper(source);
+  for (auto _ : state) {
+    Tree tree = helper.Parse();
+    CARBON_CHECK(tree.has_errors());
+  }
+
+  state.counters["tokens_per_second"] = benchmark::Counter(
+      helper.num_tokens(), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_ParseBrokenDeclarations)->Range(1 << 6, 1 << 14);
+
+}  // namespace
+}  // namespace Carbon::Parse
@@ -0,0 +1,96 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/parse/tree_index.h"
+
+#include <algorithm>
+
+#include "common/check.h"
+
+namespace Carbon::Parse {
+
+TreeIndex::TreeIndex(const Lex::TokenizedBuffer& tokens, const Tree& tree)
+    : tokens_(&tokens) {
+  parents_.resize(tree.size(), Node::Invalid);
+  first_tokens_.resize(tree.size(), Lex::Token(Lex::Token::InvalidIndex));
+  last_tokens_.resize(tree.size(), Lex::Token(Lex::Token::InvalidIndex));
+  token_nodes_.resize(tokens.size(), Node::Invalid);
+
+  // Children always precede their parent in postorder, so by the time we reach
+  // a node, the token ranges of all of its children are complete.
+  for (Node n : tree.postorder()) {
+    // When nodes share a token, the first in postorder is the innermost.
+    Lex::Token token = tree.node_token(n);
+    if (!token_nodes_[token.index].is_valid()) {
+      token_nodes_[token.index] = n;
+    }
+
+    Lex::Token first = token;
+    Lex::Token last = token;
+    for (Node child : tree.children(n)) {
+      parents_[child.index] = n;
+      first = std::min(first, first_tokens_[child.index]);
+      last = std::max(last, last_tokens_[child.index]);
+    }
+    first_tokens_[n.index] = first;
+    last_tokens_[n.index] = last;
+  }
+
+  // Sweep the tokens in order, tracking the innermost node that is still open
+  // at each one. A token with a node opens it; a skipped token is covered by
+  // the innermost ancestor of the previous token's node whose subtree extends
+  // past it. A node is popped at most once, because its subtree ends before
+  // every later token and so it is not an ancestor of any later token's node.
+  covering_nodes_.resize(tokens.size(), Node::Invalid);
+  Node open = Node::Invalid;
+  for (Lex::Token token : tokens.tokens()) {
+    if (Node n = token_nodes_[token.index]; n.is_valid()) {
+      open = n;
+    } else {
+      while (open.is_valid() && last_tokens_[open.index] < token) {
+        open = parents_[open.index];
+      }
+    }
+    covering_nodes_[token.index] = open;
+  }
+}
+
+auto TreeIndex::FindInnermostNode(Lex::Token token) const -> Node {
+  CARBON_CHECK(token.is_valid());
+  return covering_nodes_[token.index];
+}
+
+auto TreeIndex::FindInnermostNodeAtOffset(int64_t offset) const -> Node {
+  // Find the first token that starts after the offset; the token before it is
+  // the one containing or immediately preceding the offset.
+  auto token_range = tokens_->tokens();
+  auto it = std::partition_point(
+      token_range.begin(), token_range.end(), [&](Lex::Token token) {
+        return tokens_->GetByteOffset(token) <= offset;
+      });
+  if (it == token_range.begin()) {
+    return Node::Invalid;
+  }
+  return FindInnermostNode(*std::prev(it));
+}
+
+auto TreeIndex::FindInnermostNodeAt(int line_number, int column_number) const
+    -> Node {
+  // Find the first token that starts after the position; the token before it
+  // is the one containing or immediately preceding the position.
+  auto token_range = tokens_->tokens();
+  auto it = std::partition_point(
+      token_range.begin(), token_range.end(), [&](Lex::Token token) {
+        int token_line = tokens_->GetLineNumber(token);
+        return token_line < line_number ||
+               (token_line == line_number &&
+                tokens_->GetColumnNumber(token) <= column_number);
+      });
+  if (it == token_range.begin()) {
+    return Node::Invalid;
+  }
+  return FindInnermostNode(*std::prev(it));
+}
+
+}  // namespace Carbon::Parse
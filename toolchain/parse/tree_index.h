@@ -0,0 +1,91 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CARBON_TOOLCHAIN_PARSE_TREE_INDEX_H_
+#define CARBON_TOOLCHAIN_PARSE_TREE_INDEX_H_
+
+#include "llvm/ADT/SmallVector.h"
+#include "toolchain/lex/tokenized_buffer.h"
+#include "toolchain/parse/tree.h"
+
+namespace Carbon::Parse {
+
+// An index over a `Tree` supporting upward and position-based queries.
+//
+// The tree itself only supports downward traversal: children are found in
+// constant time using `subtree_size`, but finding a node's parent or the node
+// at a source position requires a walk over the whole tree. This index
+// precomputes the information needed to answer those queries cheaply:
+//
+// - A parent for each node.
+// - The node for each token, where the parser produced one.
+// - The range of tokens covered by each node's subtree.
+// - The innermost node covering each token, including skipped tokens.
+//
+// Building the index is linear in the size of the tree. It's not built by the
+// parser; clients such as the language server build it when they need it, and
+// it must not outlive the tree and tokens it refers to.
+class TreeIndex {
+ public:
+  explicit TreeIndex(const Lex::TokenizedBuffer& tokens, const Tree& tree);
+
+  // Returns the parent of the given node, or `Node::Invalid` for a root.
+  [[nodiscard]] auto GetParent(Node n) const -> Node {
+    CARBON_CHECK(n.is_valid());
+    return parents_[n.index];
+  }
+
+  // Returns the node whose token is the given token, or `Node::Invalid` if
+  // the token was skipped during error recovery. When several nodes share the
+  // token, such as a placeholder for an error and the node enclosing it, this
+  // is the innermost of them.
+  [[nodiscard]] auto GetNodeForToken(Lex::Token token) const -> Node {
+    CARBON_CHECK(token.is_valid());
+    return token_nodes_[token.index];
+  }
+
+  // Returns the first token in the subtree of the given node.
+  [[nodiscard]] auto GetFirstToken(Node n) const -> Lex::Token {
+    CARBON_CHECK(n.is_valid());
+    return first_tokens_[n.index];
+  }
+
+  // Returns the last token in the subtree of the given node.
+  [[nodiscard]] auto GetLastToken(Node n) const -> Lex::Token {
+    CARBON_CHECK(n.is_valid());
+    return last_tokens_[n.index];
+  }
+
+  // Returns the innermost node whose subtree covers the given token. This is
+  // the token's own node when there is one; otherwise, it's the innermost
+  // ancestor of the nearest preceding token's node that covers the token.
+  // Returns `Node::Invalid` when no node covers the token.
+  [[nodiscard]] auto FindInnermostNode(Lex::Token token) const -> Node;
+
+  // Returns the innermost node whose subtree covers the given zero-based byte
+  // offset in the source. The token containing or immediately preceding the
+  // offset is located by binary search. Returns `Node::Invalid` when no node
+  // covers the offset.
+  [[nodiscard]] auto FindInnermostNodeAtOffset(int64_t offset) const -> Node;
+
+  // As `FindInnermostNodeAtOffset`, but for a 1-based line and column.
+  [[nodiscard]] auto FindInnermostNodeAt(int line_number,
+                                         int column_number) const -> Node;
+
+ private:
+  const Lex::TokenizedBuffer* tokens_;
+
+  // Indexed by node.
+  llvm::SmallVector<Node> parents_;
+  llvm::SmallVector<Lex::Token> first_tokens_;
+  llvm::SmallVector<Lex::Token> last_tokens_;
+
+  // Indexed by token.
+  llvm::SmallVector<Node> token_nodes_;
+  llvm::SmallVector<Node> covering_nodes_;
+};
+
+}  // namespace Carbon::Parse
+
+#endif  // CARBON_TOOLCHAIN_PARSE_TREE_INDEX_H_
@@ -0,0 +1,169 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/parse/tree_index.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <forward_list>
+
+#include "toolchain/diagnostics/diagnostic_emitter.h"
+#include "toolchain/diagnostics/null_diagnostics.h"
+#include "toolchain/lex/tokenized_buffer.h"
+#include "toolchain/parse/node_kind.h"
+#include "toolchain/parse/tree.h"
+
+namespace Carbon::Parse {
+namespace {
+
+class TreeIndexTest : public ::testing::Test {
+ protected:
+  auto GetSourceBuffer(llvm::StringRef t) -> SourceBuffer& {
+    CARBON_CHECK(fs.addFile("test.carbon", /*ModificationTime=*/0,
+                            llvm::MemoryBuffer::getMemBuffer(t)));
+    source_storage.push_front(
+        std::move(*SourceBuffer::CreateFromFile(fs, "test.carbon", consumer)));
+    return source_storage.front();
+  }
+
+  auto GetTokenizedBuffer(llvm::StringRef t) -> Lex::TokenizedBuffer& {
+    token_storage.push_front(
+        Lex::TokenizedBuffer::Lex(GetSourceBuffer(t), consumer));
+    return token_storage.front();
+  }
+
+  llvm::vfs::InMemoryFileSystem fs;
+  std::forward_list<SourceBuffer> source_storage;
+  std::forward_list<Lex::TokenizedBuffer> token_storage;
+  DiagnosticConsumer& consumer = NullDiagnosticConsumer();
+};
+
+TEST_F(TreeIndexTest, Parents) {
+  Lex::TokenizedBuffer& tokens = GetTokenizedBuffer("fn F();");
+  Tree tree = Tree::Parse(tokens, consumer, /*vlog_stream=*/nullptr);
+  ASSERT_FALSE(tree.has_errors());
+  TreeIndex index(tokens, tree);
+
+  // Nodes are:
+  //   0: FileStart, 1: FunctionIntroducer, 2: Name, 3: ParameterListStart,
+  //   4: ParameterList, 5: FunctionDeclaration, 6: FileEnd
+  EXPECT_FALSE(index.GetParent(Node(0)).is_valid());
+  EXPECT_EQ(index.GetParent(Node(1)), Node(5));
+  EXPECT_EQ(index.GetParent(Node(2)), Node(5));
+  EXPECT_EQ(index.GetParent(Node(3)), Node(4));
+  EXPECT_EQ(index.GetParent(Node(4)), Node(5));
+  EXPECT_FALSE(index.GetParent(Node(5)).is_valid());
+  EXPECT_FALSE(index.GetParent(Node(6)).is_valid());
+}
+
+TEST_F(TreeIndexTest, TokenRanges) {
+  Lex::TokenizedBuffer& tokens = GetTokenizedBuffer("fn F();");
+  Tree tree = Tree::Parse(tokens, consumer, /*vlog_stream=*/nullptr);
+  ASSERT_FALSE(tree.has_errors());
+  TreeIndex index(tokens, tree);
+
+  for (Node n : tree.postorder()) {
+    EXPECT_EQ(index.GetNodeForToken(tree.node_token(n)), n);
+  }
+  EXPECT_EQ(index.GetFirstToken(Node(5)), tree.node_token(Node(1)));
+  EXPECT_EQ(index.GetLastToken(Node(5)), tree.node_token(Node(5)));
+  EXPECT_EQ(index.GetFirstToken(Node(4)), tree.node_token(Node(3)));
+  EXPECT_EQ(index.GetLastToken(Node(4)), tree.node_token(Node(4)));
+}
+
+TEST_F(TreeIndexTest, FindInnermostNodeAt) {
+  Lex::TokenizedBuffer& tokens = GetTokenizedBuffer("fn F();\nfn G();");
+  Tree tree = Tree::Parse(tokens, consumer, /*vlog_stream=*/nullptr);
+  ASSERT_FALSE(tree.has_errors());
+  TreeIndex index(tokens, tree);
+
+  auto kind_at = [&](int line, int column) {
+    return tree.node_kind(index.FindInnermostNodeAt(line, column));
+  };
+  EXPECT_EQ(kind_at(1, 1), NodeKind::FunctionIntroducer);
+  EXPECT_EQ(kind_at(1, 2), NodeKind::FunctionIntroducer);
+  // Whitespace is attributed to the preceding token.
+  EXPECT_EQ(kind_at(1, 3), NodeKind::FunctionIntroducer);
+  EXPECT_EQ(kind_at(1, 4), NodeKind::Name);
+  EXPECT_EQ(kind_at(1, 5), NodeKind::ParameterListStart);
+  EXPECT_EQ(kind_at(1, 6), NodeKind::ParameterList);
+  EXPECT_EQ(kind_at(1, 7), NodeKind::FunctionDeclaration);
+  EXPECT_EQ(kind_at(2, 4), NodeKind::Name);
+  EXPECT_EQ(tree.GetNodeText(index.FindInnermostNodeAt(2, 4)), "G");
+}
+
+TEST_F(TreeIndexTest, FindInnermostNodeAtOffset) {
+  Lex::TokenizedBuffer& tokens = GetTokenizedBuffer("fn F();\nfn G();");
+  Tree tree = Tree::Parse(tokens, consumer, /*vlog_stream=*/nullptr);
+  ASSERT_FALSE(tree.has_errors());
+  TreeIndex index(tokens, tree);
+
+  auto kind_at = [&](int64_t offset) {
+    return tree.node_kind(index.FindInnermostNodeAtOffset(offset));
+  };
+  EXPECT_EQ(kind_at(0), NodeKind::FunctionIntroducer);
+  EXPECT_EQ(kind_at(2), NodeKind::FunctionIntroducer);
+  EXPECT_EQ(kind_at(3), NodeKind::Name);
+  EXPECT_EQ(kind_at(6), NodeKind::FunctionDeclaration);
+  // The newline is attributed to the preceding token.
+  EXPECT_EQ(kind_at(7), NodeKind::FunctionDeclaration);
+  EXPECT_EQ(tree.GetNodeText(index.FindInnermostNodeAtOffset(11)), "G");
+}
+
+TEST_F(TreeIndexTest, SharedToken) {
+  Lex::TokenizedBuffer& tokens = GetTokenizedBuffer("fn;");
+  Tree tree = Tree::Parse(tokens, consumer, /*vlog_stream=*/nullptr);
+  ASSERT_TRUE(tree.has_errors());
+  TreeIndex index(tokens, tree);
+
+  // Both the `InvalidParse` placeholder and the `FunctionDeclaration` are
+  // associated with the `;`; the placeholder is the innermost.
+  auto semi = *(tokens.tokens().begin() + 2);
+  ASSERT_EQ(tokens.GetTokenText(semi), ";");
+  EXPECT_EQ(tree.node_kind(index.GetNodeForToken(semi)),
+            NodeKind::InvalidParse);
+  EXPECT_EQ(tree.node_kind(index.FindInnermostNode(semi)),
+            NodeKind::InvalidParse);
+}
+
+TEST_F(TreeIndexTest, SkippedTokens) {
+  Lex::TokenizedBuffer& tokens = GetTokenizedBuffer("fn F(); foo bar;");
+  Tree tree = Tree::Parse(tokens, consumer, /*vlog_stream=*/nullptr);
+  ASSERT_TRUE(tree.has_errors());
+  TreeIndex index(tokens, tree);
+
+  // `foo` and `bar` are skipped by error recovery, and the resulting
+  // `EmptyDeclaration` is only associated with the `;`.
+  auto foo = *(tokens.tokens().begin() + 6);
+  ASSERT_EQ(tokens.GetTokenText(foo), "foo");
+  EXPECT_FALSE(index.GetNodeForToken(foo).is_valid());
+  EXPECT_FALSE(index.FindInnermostNode(foo).is_valid());
+
+  Node semi = index.FindInnermostNodeAt(1, 16);
+  EXPECT_EQ(tree.node_kind(semi), NodeKind::EmptyDeclaration);
+  EXPECT_TRUE(tree.node_has_error(semi));
+}
+
+TEST_F(TreeIndexTest, SkippedTokensInsideNode) {
+  Lex::TokenizedBuffer& tokens = GetTokenizedBuffer("fn F() { foo bar baz; }");
+  Tree tree = Tree::Parse(tokens, consumer, /*vlog_stream=*/nullptr);
+  ASSERT_TRUE(tree.has_errors());
+  TreeIndex index(tokens, tree);
+
+  // `bar` and `baz` are skipped by error recovery, but are covered by the
+  // statement that starts at `foo` and ends at the `;`.
+  auto foo = *(tokens.tokens().begin() + 6);
+  ASSERT_EQ(tokens.GetTokenText(foo), "foo");
+  Node statement = index.GetParent(index.GetNodeForToken(foo));
+  EXPECT_EQ(tree.node_kind(statement), NodeKind::ExpressionStatement);
+  for (int offset : {7, 8}) {
+    auto skipped = *(tokens.tokens().begin() + offset);
+    EXPECT_FALSE(index.GetNodeForToken(skipped).is_valid());
+    EXPECT_EQ(index.FindInnermostNode(skipped), statement);
+  }
+}
+
+}  // namespace
+}  // namespace Carbon::Parse
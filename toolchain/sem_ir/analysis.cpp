@@ -0,0 +1,198 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/sem_ir/analysis.h"
+
+#include "toolchain/sem_ir/node_kind.h"
+#include "toolchain/sem_ir/node_operands.h"
+
+namespace Carbon::SemIR {
+
+NodeUses::NodeUses(const File& file) : counts_(file.nodes_size(), 0) {
+  auto add_use = [&](NodeId node_id) {
+    if (node_id.is_valid()) {
+      ++counts_[node_id.index];
+    }
+  };
+
+  for (int i = 0; i < file.nodes_size(); ++i) {
+    auto node = file.GetNode(NodeId(i));
+    ForEachNodeOperand(node, add_use);
+    if (auto block_id = GetOperandBlock(node); block_id.is_valid()) {
+      llvm::for_each(file.GetNodeBlock(block_id), add_use);
+    }
+  }
+
+  for (int i = 0; i < file.functions_size(); ++i) {
+    const auto& function = file.GetFunction(FunctionId(i));
+    if (function.param_refs_id.is_valid()) {
+      llvm::for_each(file.GetNodeBlock(function.param_refs_id), add_use);
+    }
+    add_use(function.return_slot_id);
+  }
+}
+
+ControlFlowGraph::ControlFlowGraph(const File& file, const Function& function) {
+  for (auto block_id : function.body_block_ids) {
+    blocks_[block_id];
+  }
+
+  for (auto block_id : function.body_block_ids) {
+    // Branches only appear in the terminator sequence at the end of the block.
+    for (auto node_id : llvm::reverse(file.GetNodeBlock(block_id))) {
+      auto node = file.GetNode(node_id);
+      if (node.kind().terminator_kind() == TerminatorKind::NotTerminator) {
+        break;
+      }
+      if (auto target_id = GetBranchTarget(node); target_id.is_valid()) {
+        blocks_[block_id].successors.push_back(target_id);
+        blocks_[target_id].predecessors.push_back(block_id);
+      }
+    }
+  }
+
+  if (function.body_block_ids.empty()) {
+    return;
+  }
+  llvm::SmallVector<NodeBlockId> worklist = {function.body_block_ids.front()};
+  while (!worklist.empty()) {
+    auto& edges = blocks_[worklist.pop_back_val()];
+    if (edges.reachable) {
+      continue;
+    }
+    edges.reachable = true;
+    worklist.append(edges.successors.begin(), edges.successors.end());
+  }
+}
+
+DominatorTree::DominatorTree(const ControlFlowGraph& cfg,
+                             const Function& function) {
+  if (function.body_block_ids.empty()) {
+    return;
+  }
+  root_ = function.body_block_ids.front();
+
+  // Number the reachable blocks in postorder.
+  llvm::SmallVector<NodeBlockId> postorder;
+  llvm::DenseMap<NodeBlockId, int> postorder_index;
+  llvm::SmallVector<std::pair<NodeBlockId, int>> stack = {{root_, 0}};
+  postorder_index[root_] = -1;
+  while (!stack.empty()) {
+    auto& [block_id, next_successor] = stack.back();
+    auto successors = cfg.successors(block_id);
+    if (next_successor < static_cast<int>(successors.size())) {
+      auto successor_id = successors[next_successor++];
+      if (postorder_index.insert({successor_id, -1}).second) {
+        stack.push_back({successor_id, 0});
+      }
+    } else {
+      postorder_index[block_id] = postorder.size();
+      postorder.push_back(block_id);
+      stack.pop_back();
+    }
+  }
+
+  // Compute immediate dominators using the iterative algorithm from "A Simple,
+  // Fast Dominance Algorithm" by Cooper, Harvey, and Kennedy.
+  llvm::DenseMap<NodeBlockId, NodeBlockId> idoms = {{root_, root_}};
+  auto intersect = [&](NodeBlockId a, NodeBlockId b) {
+    while (a != b) {
+      while (postorder_index[a] < postorder_index[b]) {
+        a = idoms.find(a)->second;
+      }
+      while (postorder_index[b] < postorder_index[a]) {
+        b = idoms.find(b)->second;
+      }
+    }
+    return a;
+  };
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto block_id : llvm::reverse(postorder)) {
+      if (block_id == root_) {
+        continue;
+      }
+      NodeBlockId new_idom = NodeBlockId::Invalid;
+      for (auto pred_id : cfg.predecessors(block_id)) {
+        if (!idoms.count(pred_id)) {
+          continue;
+        }
+        new_idom = new_idom.is_valid() ? intersect(pred_id, new_idom) : pred_id;
+      }
+      auto [it, inserted] = idoms.insert({block_id, new_idom});
+      if (inserted || it->second != new_idom) {
+        it->second = new_idom;
+        changed = true;
+      }
+    }
+  }
+
+  for (auto block_id : function.body_block_ids) {
+    if (block_id != root_ && cfg.is_reachable(block_id)) {
+      children_[idoms.find(block_id)->second].push_back(block_id);
+    }
+  }
+}
+
+auto AnalysisManager::GetNodeUses() -> const NodeUses& {
+  if (!node_uses_) {
+    node_uses_.emplace(*file_);
+  }
+  return *node_uses_;
+}
+
+auto AnalysisManager::GetControlFlowGraph(FunctionId function_id)
+    -> const ControlFlowGraph& {
+  if (control_flow_graphs_.size() <=
+      static_cast<size_t>(function_id.index)) {
+    control_flow_graphs_.resize(file_->functions_size());
+  }
+  auto& cfg = control_flow_graphs_[function_id.index];
+  if (!cfg) {
+    cfg.emplace(*file_, file_->GetFunction(function_id));
+  }
+  return *cfg;
+}
+
+auto AnalysisManager::GetDominatorTree(FunctionId function_id)
+    -> const DominatorTree& {
+  if (dominator_trees_.size() <= static_cast<size_t>(function_id.index)) {
+    dominator_trees_.resize(file_->functions_size());
+  }
+  auto& tree = dominator_trees_[function_id.index];
+  if (!tree) {
+    tree.emplace(GetControlFlowGraph(function_id),
+                 file_->GetFunction(function_id));
+  }
+  return *tree;
+}
+
+auto AnalysisManager::Invalidate(PreservedAnalyses preserved) -> void {
+  if (!preserved.node_uses) {
+    node_uses_.reset();
+  }
+  if (!preserved.control_flow_graph) {
+    control_flow_graphs_.clear();
+    dominator_trees_.clear();
+  }
+}
+
+auto AnalysisManager::Invalidate(FunctionId function_id,
+                                 PreservedAnalyses preserved) -> void {
+  // Use counts are shared by the whole file.
+  if (!preserved.node_uses) {
+    node_uses_.reset();
+  }
+  if (!preserved.control_flow_graph) {
+    if (static_cast<size_t>(function_id.index) < control_flow_graphs_.size()) {
+      control_flow_graphs_[function_id.index].reset();
+    }
+    if (static_cast<size_t>(function_id.index) < dominator_trees_.size()) {
+      dominator_trees_[function_id.index].reset();
+    }
+  }
+}
+
+}  // namespace Carbon::SemIR
@@ -0,0 +1,138 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CARBON_TOOLCHAIN_SEM_IR_ANALYSIS_H_
+#define CARBON_TOOLCHAIN_SEM_IR_ANALYSIS_H_
+
+#include <optional>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "toolchain/sem_ir/file.h"
+#include "toolchain/sem_ir/node.h"
+
+namespace Carbon::SemIR {
+
+// The analyses that remain valid after a pass runs. A pass that doesn't change
+// the IR preserves all analyses.
+struct PreservedAnalyses {
+  static auto All() -> PreservedAnalyses {
+    return {.node_uses = true, .control_flow_graph = true};
+  }
+  static auto None() -> PreservedAnalyses { return {}; }
+
+  bool node_uses = false;
+  bool control_flow_graph = false;
+};
+
+// Counts the references to each node from the operands of other nodes, from
+// operand blocks, and from function signatures. The position of a node in a
+// code block is not a reference.
+class NodeUses {
+ public:
+  explicit NodeUses(const File& file);
+
+  // Returns the number of references to the given node.
+  auto count(NodeId node_id) const -> int { return counts_[node_id.index]; }
+
+ private:
+  llvm::SmallVector<int32_t> counts_;
+};
+
+// The edges between the code blocks of a function body.
+class ControlFlowGraph {
+ public:
+  explicit ControlFlowGraph(const File& file, const Function& function);
+
+  // Returns the blocks that `block_id` can branch to, with one entry per
+  // branch.
+  auto successors(NodeBlockId block_id) const -> llvm::ArrayRef<NodeBlockId> {
+    return Lookup(block_id).successors;
+  }
+
+  // Returns the blocks that can branch to `block_id`, with one entry per
+  // branch.
+  auto predecessors(NodeBlockId block_id) const
+      -> llvm::ArrayRef<NodeBlockId> {
+    return Lookup(block_id).predecessors;
+  }
+
+  // Returns whether `block_id` can be reached from the entry block.
+  auto is_reachable(NodeBlockId block_id) const -> bool {
+    return Lookup(block_id).reachable;
+  }
+
+ private:
+  struct Edges {
+    llvm::SmallVector<NodeBlockId, 2> successors;
+    llvm::SmallVector<NodeBlockId, 2> predecessors;
+    bool reachable = false;
+  };
+
+  auto Lookup(NodeBlockId block_id) const -> const Edges& {
+    auto it = blocks_.find(block_id);
+    CARBON_CHECK(it != blocks_.end()) << "Not in function body: " << block_id;
+    return it->second;
+  }
+
+  llvm::DenseMap<NodeBlockId, Edges> blocks_;
+};
+
+// The dominator tree of a function body, over the blocks that are reachable
+// from the entry block.
+class DominatorTree {
+ public:
+  explicit DominatorTree(const ControlFlowGraph& cfg, const Function& function);
+
+  // Returns the entry block, which is the root of the tree.
+  auto root() const -> NodeBlockId { return root_; }
+
+  // Returns the blocks immediately dominated by `block_id`, in lexical order.
+  auto children(NodeBlockId block_id) const -> llvm::ArrayRef<NodeBlockId> {
+    auto it = children_.find(block_id);
+    return it == children_.end() ? llvm::ArrayRef<NodeBlockId>() : it->second;
+  }
+
+ private:
+  NodeBlockId root_ = NodeBlockId::Invalid;
+  llvm::DenseMap<NodeBlockId, llvm::SmallVector<NodeBlockId, 2>> children_;
+};
+
+// Computes analyses on demand for the passes run over a file, and caches them
+// until a pass reports that they are no longer valid.
+class AnalysisManager {
+ public:
+  explicit AnalysisManager(const File& file) : file_(&file) {}
+
+  // Returns the use counts for nodes in the file.
+  auto GetNodeUses() -> const NodeUses&;
+
+  // Returns the control flow graph for a function with a body.
+  auto GetControlFlowGraph(FunctionId function_id) -> const ControlFlowGraph&;
+
+  // Returns the dominator tree for a function with a body.
+  auto GetDominatorTree(FunctionId function_id) -> const DominatorTree&;
+
+  // Discards analyses that were not preserved by a pass over the whole file.
+  auto Invalidate(PreservedAnalyses preserved) -> void;
+
+  // Discards analyses that were not preserved by a pass over a single
+  // function. Analyses of other functions are kept.
+  auto Invalidate(FunctionId function_id, PreservedAnalyses preserved) -> void;
+
+ private:
+  const File* file_;
+
+  std::optional<NodeUses> node_uses_;
+
+  // Indexed by FunctionId. Dominator trees are derived from the control flow
+  // graph, and are invalidated along with it.
+  llvm::SmallVector<std::optional<ControlFlowGraph>> control_flow_graphs_;
+  llvm::SmallVector<std::optional<DominatorTree>> dominator_trees_;
+};
+
+}  // namespace Carbon::SemIR
+
+#endif  // CARBON_TOOLCHAIN_SEM_IR_ANALYSIS_H_
@@ -36,7 +36,8 @@ File::File()
       << " nodes, actual: " << nodes_.size();
 }
 
-File::File(std::string filename, const File* builtins)
+File::File(std::string filename, const File* builtins,
+           llvm::ArrayRef<const File*> import_irs)
     // Builtins are always the first IR.
     : filename_(std::move(filename)),
       cross_reference_irs_({builtins}),
@@ -45,6 +46,7 @@ File::File(std::string filename, const File* builtins)
   CARBON_CHECK(builtins != nullptr);
   CARBON_CHECK(builtins->cross_reference_irs_[0] == builtins)
       << "Not called with builtins!";
+  cross_reference_irs_.append(import_irs.begin(), import_irs.end());
 
   // Copy builtins over.
   nodes_.reserve(BuiltinKind::ValidCount);
@@ -92,6 +94,66 @@ auto File::Verify() const -> ErrorOr<Success> {
   return Success();
 }
 
+// Returns the position of the first entry in `entries`, which are sorted by
+// name ID, whose name ID isn't less than `name_id`.
+static auto FindNameScopeEntry(llvm::ArrayRef<NameScopeEntry> entries,
+                               StringId name_id) -> size_t {
+  return llvm::partition_point(entries,
+                               [&](const NameScopeEntry& entry) {
+                                 return entry.name_id.index < name_id.index;
+                               }) -
+         entries.begin();
+}
+
+auto File::AddNameScopeEntry(NameScopeId scope_id, StringId name_id,
+                             NodeId target_id) -> bool {
+  CARBON_CHECK(!name_scopes_frozen_) << "Name scopes are frozen";
+  if (!name_scope_lookup_.insert({{scope_id, name_id}, target_id}).second) {
+    return false;
+  }
+  name_scopes_[scope_id.index].push_back(
+      {.name_id = name_id, .node_id = target_id});
+  return true;
+}
+
+auto File::LookupNameScopeEntry(NameScopeId scope_id, StringId name_id) const
+    -> NodeId {
+  if (!name_scopes_frozen_) {
+    auto it = name_scope_lookup_.find({scope_id, name_id});
+    return it != name_scope_lookup_.end() ? it->second : NodeId::Invalid;
+  }
+  auto entries = GetNameScope(scope_id);
+  auto pos = FindNameScopeEntry(entries, name_id);
+  if (pos != entries.size() && entries[pos].name_id == name_id) {
+    return entries[pos].node_id;
+  }
+  return NodeId::Invalid;
+}
+
+auto File::FreezeNameScopes() -> void {
+  CARBON_CHECK(!name_scopes_frozen_) << "Name scopes are already frozen";
+  size_t num_entries = 0;
+  for (const auto& entries : name_scopes_) {
+    num_entries += entries.size();
+  }
+  auto storage = AllocateUninitialized<NameScopeEntry>(num_entries);
+  frozen_name_scopes_.reserve(name_scopes_.size());
+  for (const auto& entries : name_scopes_) {
+    auto frozen = storage.take_front(entries.size());
+    std::uninitialized_copy(entries.begin(), entries.end(), frozen.begin());
+    llvm::sort(frozen,
+               [](const NameScopeEntry& lhs, const NameScopeEntry& rhs) {
+                 return lhs.name_id.index < rhs.name_id.index;
+               });
+    frozen_name_scopes_.push_back(frozen);
+    storage = storage.drop_front(entries.size());
+  }
+  // Release the per-scope storage and the lookup table.
+  name_scopes_.clear();
+  name_scope_lookup_.clear();
+  name_scopes_frozen_ = true;
+}
+
 static constexpr int BaseIndent = 4;
 static constexpr int IndentStep = 2;
 
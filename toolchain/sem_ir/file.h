@@ -5,6 +5,10 @@
 #ifndef CARBON_TOOLCHAIN_SEM_IR_FILE_H_
 #define CARBON_TOOLCHAIN_SEM_IR_FILE_H_
 
+#include <optional>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/iterator_range.h"
@@ -51,6 +55,12 @@ struct Function : public Printable<Function> {
   llvm::SmallVector<NodeBlockId> body_block_ids;
 };
 
+// An entry in a name scope.
+struct NameScopeEntry {
+  StringId name_id;
+  NodeId node_id;
+};
+
 struct RealLiteral : public Printable<RealLiteral> {
   auto Print(llvm::raw_ostream& out) const -> void {
     out << "{mantissa: ";
@@ -73,7 +83,10 @@ class File : public Printable<File> {
   explicit File();
 
   // Starts a new file for Check::CheckParseTree. Builtins are required.
-  explicit File(std::string filename, const File* builtins);
+  // `import_irs` are the checked files whose declarations may be imported, and
+  // are referenced by the cross-reference IR IDs following builtins.
+  explicit File(std::string filename, const File* builtins,
+                llvm::ArrayRef<const File*> import_irs = {});
 
   // Verifies that invariants of the semantics IR hold.
   auto Verify() const -> ErrorOr<Success>;
@@ -100,6 +113,11 @@ class File : public Printable<File> {
     return *cross_reference_irs_[xref_id.index];
   }
 
+  // Returns the number of related IRs, including builtins.
+  auto cross_reference_irs_size() const -> int {
+    return cross_reference_irs_.size();
+  }
+
   // Adds a callable, returning an ID to reference it.
   auto AddFunction(Function function) -> FunctionId {
     FunctionId id(functions_.size());
@@ -135,26 +153,39 @@ class File : public Printable<File> {
 
   // Adds a name scope, returning an ID to reference it.
   auto AddNameScope() -> NameScopeId {
+    CARBON_CHECK(!name_scopes_frozen_) << "Name scopes are frozen";
     NameScopeId name_scopes_id(name_scopes_.size());
     // TODO: Return failure on overflow instead of crashing.
     CARBON_CHECK(name_scopes_id.index >= 0);
-    name_scopes_.resize(name_scopes_id.index + 1);
+    name_scopes_.emplace_back();
     return name_scopes_id;
   }
 
   // Adds an entry to a name scope. Returns true on success, false on
   // duplicates.
   auto AddNameScopeEntry(NameScopeId scope_id, StringId name_id,
-                         NodeId target_id) -> bool {
-    return name_scopes_[scope_id.index].insert({name_id, target_id}).second;
-  }
+                         NodeId target_id) -> bool;
 
-  // Returns the requested name scope.
+  // Returns the entries of the requested name scope. Once the scopes are
+  // frozen, the entries are sorted by name ID; before that, they're in the
+  // order they were added.
   auto GetNameScope(NameScopeId scope_id) const
-      -> const llvm::DenseMap<StringId, NodeId>& {
+      -> llvm::ArrayRef<NameScopeEntry> {
+    if (name_scopes_frozen_) {
+      return frozen_name_scopes_[scope_id.index];
+    }
     return name_scopes_[scope_id.index];
   }
 
+  // Returns the node that a name scope maps a name to, or an invalid ID if the
+  // name isn't in the scope.
+  auto LookupNameScopeEntry(NameScopeId scope_id, StringId name_id) const
+      -> NodeId;
+
+  // Moves the entries of all name scopes into a single allocation, after which
+  // no scopes or entries can be added. Called once declarations are complete.
+  auto FreezeNameScopes() -> void;
+
   // Adds a node to the node list, returning an ID to reference the node. Note
   // that this doesn't add the node to any node block. Check::Context::AddNode
   // or NodeBlockStack::AddNode should usually be used instead, to add the node
@@ -195,6 +226,15 @@ class File : public Printable<File> {
     node_blocks_[block_id.index] = AllocateCopy(content);
   }
 
+  // Replaces the contents of a node block, which may change its size. This is
+  // intended for transformations of a checked file; `content` may alias the
+  // current contents.
+  auto ReplaceNodeBlock(NodeBlockId block_id, llvm::ArrayRef<NodeId> content)
+      -> void {
+    CARBON_CHECK(block_id != NodeBlockId::Unreachable);
+    node_blocks_[block_id.index] = AllocateCopy(content);
+  }
+
   // Adds a node block with the given content, returning an ID to reference it.
   auto AddNodeBlock(llvm::ArrayRef<NodeId> content) -> NodeBlockId {
     NodeBlockId id(node_blocks_.size());
@@ -261,6 +301,15 @@ class File : public Printable<File> {
     return strings_[string_id.index];
   }
 
+  // Returns the ID of a string if it has been added, without adding it.
+  auto LookupString(llvm::StringRef str) const -> std::optional<StringId> {
+    auto it = string_to_id_.find(str);
+    if (it == string_to_id_.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
   // Adds a type, returning an ID to reference it.
   auto AddType(NodeId node_id) -> TypeId {
     TypeId type_id(types_.size());
@@ -329,6 +378,20 @@ class File : public Printable<File> {
     top_node_block_id_ = block_id;
   }
 
+  // The block of nodes materialized for declarations imported from other IRs.
+  // Invalid if nothing was imported.
+  auto imports_block_id() const -> NodeBlockId { return imports_block_id_; }
+  auto set_imports_block_id(NodeBlockId block_id) -> void {
+    imports_block_id_ = block_id;
+  }
+
+  // The name scope of the file's top-level declarations, which is what other
+  // files can import. Invalid until checking completes.
+  auto file_scope_id() const -> NameScopeId { return file_scope_id_; }
+  auto set_file_scope_id(NameScopeId scope_id) -> void {
+    file_scope_id_ = scope_id;
+  }
+
   // Returns true if there were errors creating the semantics IR.
   auto has_errors() const -> bool { return has_errors_; }
   auto set_has_errors(bool has_errors) -> void { has_errors_ = has_errors; }
@@ -367,16 +430,21 @@ class File : public Printable<File> {
   // Storage for callable objects.
   llvm::SmallVector<Function> functions_;
 
-  // Related IRs. There will always be at least 2 entries, the builtin IR (used
-  // for references of builtins) followed by the current IR (used for references
-  // crossing node blocks).
+  // Related IRs. The builtin IR (used for references of builtins) is always
+  // first, followed by the IRs that declarations may be imported from.
   llvm::SmallVector<const File*> cross_reference_irs_;
 
   // Storage for integer literals.
   llvm::SmallVector<llvm::APInt> integer_literals_;
 
-  // Storage for name scopes.
-  llvm::SmallVector<llvm::DenseMap<StringId, NodeId>> name_scopes_;
+  // Storage for name scopes. While scopes are being built, each entry owns its
+  // own storage, in the order names were added, and lookups use
+  // name_scope_lookup_. Once they're frozen, entries refer to contiguous
+  // storage provided by allocator_, sorted by name ID.
+  llvm::SmallVector<llvm::SmallVector<NameScopeEntry, 0>> name_scopes_;
+  llvm::DenseMap<std::pair<NameScopeId, StringId>, NodeId> name_scope_lookup_;
+  llvm::SmallVector<llvm::ArrayRef<NameScopeEntry>> frozen_name_scopes_;
+  bool name_scopes_frozen_ = false;
 
   // Storage for real literals.
   llvm::SmallVector<RealLiteral> real_literals_;
@@ -404,6 +472,12 @@ class File : public Printable<File> {
 
   // The top node block ID.
   NodeBlockId top_node_block_id_ = NodeBlockId::Invalid;
+
+  // The block of imported declarations.
+  NodeBlockId imports_block_id_ = NodeBlockId::Invalid;
+
+  // The name scope of top-level declarations.
+  NameScopeId file_scope_id_ = NameScopeId::Invalid;
 };
 
 // The expression category of a semantics node. See /docs/design/values.md for
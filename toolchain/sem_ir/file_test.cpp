@@ -5,78 +5,49 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
-#include "common/ostream.h"
-#include "llvm/Support/MemoryBuffer.h"
-#include "llvm/Support/VirtualFileSystem.h"
-#include "testing/base/test_raw_ostream.h"
-#include "toolchain/driver/driver.h"
-#include "toolchain/testing/yaml_test_helpers.h"
+#include "toolchain/sem_ir/file.h"
 
 namespace Carbon::SemIR {
 namespace {
 
-using ::Carbon::Testing::TestRawOstream;
-using ::testing::_;
-using ::testing::AllOf;
-using ::testing::Contains;
-using ::testing::Each;
-using ::testing::ElementsAre;
 using ::testing::IsEmpty;
-using ::testing::MatchesRegex;
-using ::testing::Pair;
 using ::testing::SizeIs;
 
-namespace Yaml = ::Carbon::Testing::Yaml;
-
-TEST(SemIRTest, YAML) {
-  llvm::vfs::InMemoryFileSystem fs;
-  CARBON_CHECK(fs.addFile(
-      "test.carbon", /*ModificationTime=*/0,
-      llvm::MemoryBuffer::getMemBuffer("fn F() { var x: i32 = 0; return; }")));
-  TestRawOstream print_stream;
-  Driver d(fs, print_stream, llvm::errs());
-  d.RunCommand(
-      {"compile", "--phase=check", "--dump-raw-sem-ir", "test.carbon"});
-
-  // Matches the ID of a node. The numbers may change because of builtin
-  // cross-references, so this code is only doing loose structural checks.
-  auto node_id = Yaml::Scalar(MatchesRegex(R"(node\+\d+)"));
-  auto node_builtin = Yaml::Scalar(MatchesRegex(R"(node\w+)"));
-  auto type_id = Yaml::Scalar(MatchesRegex(R"(type\d+)"));
-
-  auto file = Yaml::Sequence(ElementsAre(Yaml::Mapping(ElementsAre(
-      Pair("cross_reference_irs_size", "1"),
-      Pair("functions", Yaml::Sequence(SizeIs(1))),
-      Pair("integer_literals", Yaml::Sequence(ElementsAre("0"))),
-      Pair("real_literals", Yaml::Sequence(IsEmpty())),
-      Pair("strings", Yaml::Sequence(ElementsAre("F", "x"))),
-      Pair("types", Yaml::Sequence(ElementsAre(node_builtin))),
-      Pair("type_blocks", Yaml::Sequence(IsEmpty())),
-      Pair("nodes",
-           Yaml::Sequence(AllOf(
-               // kind is required, other parts are optional.
-               Each(Yaml::Mapping(Contains(Pair("kind", _)))),
-               // A 0-arg node.
-               Contains(Yaml::Mapping(ElementsAre(Pair("kind", "Return")))),
-               // A 1-arg node.
-               Contains(Yaml::Mapping(
-                   ElementsAre(Pair("kind", "IntegerLiteral"),
-                               Pair("arg0", "int0"), Pair("type", type_id)))),
-               // A 2-arg node.
-               Contains(Yaml::Mapping(ElementsAre(Pair("kind", "Assign"),
-                                                  Pair("arg0", node_id),
-                                                  Pair("arg1", node_id))))))),
-      // This production has only two node blocks.
-      Pair("node_blocks",
-           Yaml::Sequence(ElementsAre(Yaml::Sequence(IsEmpty()),
-                                      Yaml::Sequence(Each(node_id)),
-                                      Yaml::Sequence(Each(node_id)))))))));
-
-  auto root = Yaml::Sequence(ElementsAre(Yaml::Mapping(
-      ElementsAre(Pair("filename", "test.carbon"), Pair("sem_ir", file)))));
-
-  EXPECT_THAT(Yaml::Value::FromText(print_stream.TakeStr()),
-              IsYaml(ElementsAre(root)));
+TEST(SemIRTest, NameScopes) {
+  File builtins;
+  File file("test.carbon", &builtins);
+  auto scope_id = file.AddNameScope();
+  auto empty_scope_id = file.AddNameScope();
+  auto a_id = file.AddString("a");
+  auto b_id = file.AddString("b");
+  auto c_id = file.AddString("c");
+  auto node_1 = NodeId(BuiltinKind::ValidCount + 1);
+  auto node_2 = NodeId(BuiltinKind::ValidCount + 2);
+  auto node_3 = NodeId(BuiltinKind::ValidCount + 3);
+
+  EXPECT_TRUE(file.AddNameScopeEntry(scope_id, c_id, node_1));
+  EXPECT_TRUE(file.AddNameScopeEntry(scope_id, a_id, node_2));
+  EXPECT_FALSE(file.AddNameScopeEntry(scope_id, c_id, node_3));
+  EXPECT_EQ(file.LookupNameScopeEntry(scope_id, a_id), node_2);
+  EXPECT_EQ(file.LookupNameScopeEntry(scope_id, b_id), NodeId::Invalid);
+
+  // Until the scopes are frozen, entries are in the order they were added.
+  auto unfrozen_entries = file.GetNameScope(scope_id);
+  ASSERT_THAT(unfrozen_entries, SizeIs(2));
+  EXPECT_EQ(unfrozen_entries[0].name_id, c_id);
+  EXPECT_EQ(unfrozen_entries[1].name_id, a_id);
+
+  file.FreezeNameScopes();
+
+  // Entries are kept, sorted by name.
+  auto entries = file.GetNameScope(scope_id);
+  ASSERT_THAT(entries, SizeIs(2));
+  EXPECT_EQ(entries[0].name_id, a_id);
+  EXPECT_EQ(entries[1].name_id, c_id);
+  EXPECT_THAT(file.GetNameScope(empty_scope_id), IsEmpty());
+  EXPECT_EQ(file.LookupNameScopeEntry(scope_id, c_id), node_1);
+  EXPECT_EQ(file.LookupNameScopeEntry(scope_id, a_id), node_2);
+  EXPECT_EQ(file.LookupNameScopeEntry(scope_id, b_id), NodeId::Invalid);
 }
 
 }  // namespace
@@ -42,6 +42,7 @@ class NodeNamer {
     // Build the package scope.
     GetScopeInfo(ScopeIndex::Package).name =
         globals.AddNameUnchecked("package");
+    CollectNamesInBlock(ScopeIndex::Package, semantics_ir.imports_block_id());
     CollectNamesInBlock(ScopeIndex::Package, semantics_ir.top_node_block_id());
 
     // Build each function scope.
@@ -374,6 +375,23 @@ class NodeNamer {
           add_node_name_id(name_id);
           continue;
         }
+        case NodeKind::CrossReference: {
+          // Name imported entities after their declaration.
+          auto [xref_id, xref_node_id] = node.GetAsCrossReference();
+          const auto& xref_ir = semantics_ir_.GetCrossReferenceIR(xref_id);
+          auto xref_node = xref_ir.GetNode(xref_node_id);
+          if (xref_node.kind() == NodeKind::VarStorage) {
+            add_node_name(
+                xref_ir.GetString(xref_node.GetAsVarStorage()).str());
+            continue;
+          }
+          if (xref_node.kind() == NodeKind::BindName) {
+            auto [name_id, value_id] = xref_node.GetAsBindName();
+            add_node_name(xref_ir.GetString(name_id).str());
+            continue;
+          }
+          break;
+        }
         case NodeKind::FunctionDeclaration: {
           add_node_name_id(
               semantics_ir_.GetFunction(node.GetAsFunctionDeclaration())
@@ -441,11 +459,11 @@ class Formatter {
     // TODO: Handle the case where there are multiple top-level node blocks.
     // For example, there may be branching in the initializer of a global or a
     // type expression.
-    if (auto block_id = semantics_ir_.top_node_block_id();
-        block_id.is_valid()) {
+    {
       llvm::SaveAndRestore package_scope(scope_,
                                          NodeNamer::ScopeIndex::Package);
-      FormatCodeBlock(block_id);
+      FormatCodeBlock(semantics_ir_.imports_block_id());
+      FormatCodeBlock(semantics_ir_.top_node_block_id());
     }
     out_ << "}\n";
 
@@ -758,8 +776,8 @@ class Formatter {
   // TODO: Should we be printing scopes inline, or should we have a separate
   // step to print them like we do for functions?
   auto FormatArg(NameScopeId id) -> void {
-    // Name scopes aren't kept in any particular order. Sort the entries before
-    // we print them for stability and consistency.
+    // Name scopes are sorted by name ID. Sort the entries by node before we
+    // print them, so they appear in declaration order.
     std::vector<std::pair<NodeId, StringId>> entries;
     for (auto [name_id, node_id] : semantics_ir_.GetNameScope(id)) {
       entries.push_back({node_id, name_id});
@@ -535,6 +535,9 @@ struct IdMapInfo {
 
 // Support use of Id types as DenseMap/DenseSet keys.
 template <>
+struct llvm::DenseMapInfo<Carbon::SemIR::NameScopeId>
+    : public Carbon::SemIR::IdMapInfo<Carbon::SemIR::NameScopeId> {};
+template <>
 struct llvm::DenseMapInfo<Carbon::SemIR::NodeBlockId>
     : public Carbon::SemIR::IdMapInfo<Carbon::SemIR::NodeBlockId> {};
 template <>
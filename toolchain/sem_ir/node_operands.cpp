@@ -0,0 +1,197 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/sem_ir/node_operands.h"
+
+#include "toolchain/sem_ir/node_kind.h"
+
+namespace Carbon::SemIR {
+
+auto MapNodeOperands(Node node, llvm::function_ref<NodeId(NodeId)> map)
+    -> Node {
+  auto parse_node = node.parse_node();
+  auto type_id = node.type_id();
+  switch (node.kind()) {
+    case NodeKind::AddressOf:
+      return Node::AddressOf::Make(parse_node, type_id,
+                                   map(node.GetAsAddressOf()));
+    case NodeKind::ArrayIndex: {
+      auto [array_id, index_id] = node.GetAsArrayIndex();
+      return Node::ArrayIndex::Make(parse_node, type_id, map(array_id),
+                                    map(index_id));
+    }
+    case NodeKind::ArrayInit: {
+      auto [tuple_id, refs_id] = node.GetAsArrayInit();
+      return Node::ArrayInit::Make(parse_node, type_id, map(tuple_id), refs_id);
+    }
+    case NodeKind::ArrayType: {
+      auto [bound_id, element_type_id] = node.GetAsArrayType();
+      return Node::ArrayType::Make(parse_node, type_id, map(bound_id),
+                                   element_type_id);
+    }
+    case NodeKind::Assign: {
+      auto [lhs_id, rhs_id] = node.GetAsAssign();
+      return Node::Assign::Make(parse_node, map(lhs_id), map(rhs_id));
+    }
+    case NodeKind::BinaryOperatorAdd: {
+      auto [lhs_id, rhs_id] = node.GetAsBinaryOperatorAdd();
+      return Node::BinaryOperatorAdd::Make(parse_node, type_id, map(lhs_id),
+                                           map(rhs_id));
+    }
+    case NodeKind::BindName: {
+      auto [name_id, value_id] = node.GetAsBindName();
+      return Node::BindName::Make(parse_node, type_id, name_id, map(value_id));
+    }
+    case NodeKind::BindValue:
+      return Node::BindValue::Make(parse_node, type_id,
+                                   map(node.GetAsBindValue()));
+    case NodeKind::BranchIf: {
+      auto [target_id, cond_id] = node.GetAsBranchIf();
+      return Node::BranchIf::Make(parse_node, target_id, map(cond_id));
+    }
+    case NodeKind::BranchWithArg: {
+      auto [target_id, arg_id] = node.GetAsBranchWithArg();
+      return Node::BranchWithArg::Make(parse_node, target_id, map(arg_id));
+    }
+    case NodeKind::Dereference:
+      return Node::Dereference::Make(parse_node, type_id,
+                                     map(node.GetAsDereference()));
+    case NodeKind::InitializeFrom: {
+      auto [src_id, dest_id] = node.GetAsInitializeFrom();
+      return Node::InitializeFrom::Make(parse_node, type_id, map(src_id),
+                                        map(dest_id));
+    }
+    case NodeKind::NameReference: {
+      auto [name_id, value_id] = node.GetAsNameReference();
+      return Node::NameReference::Make(parse_node, type_id, name_id,
+                                       map(value_id));
+    }
+    case NodeKind::NameReferenceUntyped: {
+      auto [name_id, value_id] = node.GetAsNameReferenceUntyped();
+      return Node::NameReferenceUntyped::Make(parse_node, type_id, name_id,
+                                              map(value_id));
+    }
+    case NodeKind::ReturnExpression:
+      return Node::ReturnExpression::Make(parse_node,
+                                          map(node.GetAsReturnExpression()));
+    case NodeKind::SpliceBlock: {
+      auto [block_id, result_id] = node.GetAsSpliceBlock();
+      return Node::SpliceBlock::Make(parse_node, type_id, block_id,
+                                     map(result_id));
+    }
+    case NodeKind::StructAccess: {
+      auto [struct_id, index] = node.GetAsStructAccess();
+      return Node::StructAccess::Make(parse_node, type_id, map(struct_id),
+                                      index);
+    }
+    case NodeKind::StructInit: {
+      auto [literal_id, refs_id] = node.GetAsStructInit();
+      return Node::StructInit::Make(parse_node, type_id, map(literal_id),
+                                    refs_id);
+    }
+    case NodeKind::StructValue: {
+      auto [literal_id, refs_id] = node.GetAsStructValue();
+      return Node::StructValue::Make(parse_node, type_id, map(literal_id),
+                                     refs_id);
+    }
+    case NodeKind::Temporary: {
+      auto [storage_id, init_id] = node.GetAsTemporary();
+      return Node::Temporary::Make(parse_node, type_id, map(storage_id),
+                                   map(init_id));
+    }
+    case NodeKind::TupleAccess: {
+      auto [tuple_id, index] = node.GetAsTupleAccess();
+      return Node::TupleAccess::Make(parse_node, type_id, map(tuple_id), index);
+    }
+    case NodeKind::TupleIndex: {
+      auto [tuple_id, index_id] = node.GetAsTupleIndex();
+      return Node::TupleIndex::Make(parse_node, type_id, map(tuple_id),
+                                    map(index_id));
+    }
+    case NodeKind::TupleInit: {
+      auto [literal_id, refs_id] = node.GetAsTupleInit();
+      return Node::TupleInit::Make(parse_node, type_id, map(literal_id),
+                                   refs_id);
+    }
+    case NodeKind::TupleValue: {
+      auto [literal_id, refs_id] = node.GetAsTupleValue();
+      return Node::TupleValue::Make(parse_node, type_id, map(literal_id),
+                                    refs_id);
+    }
+    case NodeKind::UnaryOperatorNot:
+      return Node::UnaryOperatorNot::Make(parse_node, type_id,
+                                          map(node.GetAsUnaryOperatorNot()));
+    case NodeKind::ValueAsReference:
+      return Node::ValueAsReference::Make(parse_node, type_id,
+                                          map(node.GetAsValueAsReference()));
+    case NodeKind::BlockArg:
+    case NodeKind::BoolLiteral:
+    case NodeKind::Branch:
+    case NodeKind::Builtin:
+    case NodeKind::Call:
+    case NodeKind::ConstType:
+    case NodeKind::CrossReference:
+    case NodeKind::FunctionDeclaration:
+    case NodeKind::IntegerLiteral:
+    case NodeKind::Namespace:
+    case NodeKind::NoOp:
+    case NodeKind::Parameter:
+    case NodeKind::PointerType:
+    case NodeKind::RealLiteral:
+    case NodeKind::Return:
+    case NodeKind::StringLiteral:
+    case NodeKind::StructLiteral:
+    case NodeKind::StructType:
+    case NodeKind::StructTypeField:
+    case NodeKind::TemporaryStorage:
+    case NodeKind::TupleLiteral:
+    case NodeKind::TupleType:
+    case NodeKind::VarStorage:
+      // No node operands, other than possibly an operand block.
+      return node;
+    case NodeKind::Invalid:
+      llvm_unreachable("NodeKind::Invalid is never used.");
+  }
+  llvm_unreachable("All node kinds handled!");
+}
+
+auto GetOperandBlock(Node node) -> NodeBlockId {
+  switch (node.kind()) {
+    case NodeKind::ArrayInit:
+      return node.GetAsArrayInit().second;
+    case NodeKind::Call:
+      return node.GetAsCall().first;
+    case NodeKind::StructInit:
+      return node.GetAsStructInit().second;
+    case NodeKind::StructLiteral:
+      return node.GetAsStructLiteral();
+    case NodeKind::StructType:
+      return node.GetAsStructType();
+    case NodeKind::StructValue:
+      return node.GetAsStructValue().second;
+    case NodeKind::TupleInit:
+      return node.GetAsTupleInit().second;
+    case NodeKind::TupleLiteral:
+      return node.GetAsTupleLiteral();
+    case NodeKind::TupleValue:
+      return node.GetAsTupleValue().second;
+    default:
+      return NodeBlockId::Invalid;
+  }
+}
+
+auto GetBranchTarget(Node node) -> NodeBlockId {
+  switch (node.kind()) {
+    case NodeKind::Branch:
+      return node.GetAsBranch();
+    case NodeKind::BranchIf:
+      return node.GetAsBranchIf().first;
+    case NodeKind::BranchWithArg:
+      return node.GetAsBranchWithArg().first;
+    default:
+      return NodeBlockId::Invalid;
+  }
+}
+
+}  // namespace Carbon::SemIR
@@ -0,0 +1,40 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CARBON_TOOLCHAIN_SEM_IR_NODE_OPERANDS_H_
+#define CARBON_TOOLCHAIN_SEM_IR_NODE_OPERANDS_H_
+
+#include "llvm/ADT/STLExtras.h"
+#include "toolchain/sem_ir/node.h"
+
+namespace Carbon::SemIR {
+
+// Returns a copy of `node` with each operand that refers to a node in the same
+// file replaced by `map(operand)`. Cross-references are not mapped, because
+// their operand refers to a node in a different file.
+auto MapNodeOperands(Node node, llvm::function_ref<NodeId(NodeId)> map)
+    -> Node;
+
+// Calls `fn` for each operand of `node` that refers to a node in the same file.
+inline auto ForEachNodeOperand(Node node, llvm::function_ref<void(NodeId)> fn)
+    -> void {
+  MapNodeOperands(node, [&](NodeId operand_id) {
+    fn(operand_id);
+    return operand_id;
+  });
+}
+
+// Returns the block of operands used by `node`, such as the arguments of a call
+// or the elements of a tuple literal, or `NodeBlockId::Invalid` if there is no
+// such block. Blocks of code, such as the target of a branch or the body of a
+// `SpliceBlock`, are not operand blocks.
+auto GetOperandBlock(Node node) -> NodeBlockId;
+
+// Returns the code block that `node` may transfer control to, or
+// `NodeBlockId::Invalid` if `node` is not a branch.
+auto GetBranchTarget(Node node) -> NodeBlockId;
+
+}  // namespace Carbon::SemIR
+
+#endif  // CARBON_TOOLCHAIN_SEM_IR_NODE_OPERANDS_H_
@@ -0,0 +1,43 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/sem_ir/pass_kind.h"
+
+#include "llvm/ADT/STLExtras.h"
+
+namespace Carbon::SemIR {
+
+CARBON_DEFINE_ENUM_CLASS_NAMES(PassKind) = {
+#define CARBON_SEM_IR_PASS(Name) CARBON_ENUM_CLASS_NAME_STRING(Name)
+#include "toolchain/sem_ir/pass_kind.def"
+};
+
+static constexpr llvm::StringLiteral FlagNames[] = {
+#define CARBON_SEM_IR_PASS_WITH_INFO(Name, FlagName, Scope) FlagName,
+#include "toolchain/sem_ir/pass_kind.def"
+};
+
+auto PassKind::FromFlagName(llvm::StringRef flag_name)
+    -> std::optional<PassKind> {
+  for (auto [i, name] : llvm::enumerate(FlagNames)) {
+    if (name == flag_name) {
+      return PassKind::FromInt(i);
+    }
+  }
+  return std::nullopt;
+}
+
+auto PassKind::flag_name() const -> llvm::StringRef {
+  return FlagNames[AsInt()];
+}
+
+auto PassKind::scope() const -> PassScope {
+  static constexpr PassScope Table[] = {
+#define CARBON_SEM_IR_PASS_WITH_INFO(Name, FlagName, Scope) PassScope::Scope,
+#include "toolchain/sem_ir/pass_kind.def"
+  };
+  return Table[AsInt()];
+}
+
+}  // namespace Carbon::SemIR
@@ -0,0 +1,52 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CARBON_TOOLCHAIN_SEM_IR_PASS_KIND_H_
+#define CARBON_TOOLCHAIN_SEM_IR_PASS_KIND_H_
+
+#include <cstdint>
+#include <optional>
+
+#include "common/enum_base.h"
+
+namespace Carbon::SemIR {
+
+// The unit of IR that a pass transforms in a single invocation.
+enum class PassScope : int8_t {
+  // The pass runs once over the whole file.
+  File,
+  // The pass runs once for each function that has a body.
+  Function,
+};
+
+CARBON_DEFINE_RAW_ENUM_CLASS(PassKind, uint8_t) {
+#define CARBON_SEM_IR_PASS(Name) CARBON_RAW_ENUM_ENUMERATOR(Name)
+#include "toolchain/sem_ir/pass_kind.def"
+};
+
+// A SemIR-to-SemIR transformation that can be run by a `PassManager`.
+class PassKind : public CARBON_ENUM_BASE(PassKind) {
+ public:
+#define CARBON_SEM_IR_PASS(Name) CARBON_ENUM_CONSTANT_DECLARATION(Name)
+#include "toolchain/sem_ir/pass_kind.def"
+
+  // Returns the pass with the given flag name, if any.
+  static auto FromFlagName(llvm::StringRef flag_name)
+      -> std::optional<PassKind>;
+
+  // Returns the name used to select this pass on the command line.
+  [[nodiscard]] auto flag_name() const -> llvm::StringRef;
+
+  // Returns the unit of IR that this pass transforms.
+  [[nodiscard]] auto scope() const -> PassScope;
+
+  using EnumBase::AsInt;
+};
+
+#define CARBON_SEM_IR_PASS(Name) CARBON_ENUM_CONSTANT_DEFINITION(PassKind, Name)
+#include "toolchain/sem_ir/pass_kind.def"
+
+}  // namespace Carbon::SemIR
+
+#endif  // CARBON_TOOLCHAIN_SEM_IR_PASS_KIND_H_
@@ -0,0 +1,99 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/sem_ir/pass_manager.h"
+
+#include "common/check.h"
+#include "common/vlog.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "toolchain/sem_ir/analysis.h"
+#include "toolchain/sem_ir/passes.h"
+
+namespace Carbon::SemIR {
+
+auto PassManager::AddPasses(llvm::StringRef pass_list) -> ErrorOr<Success> {
+  llvm::SmallVector<llvm::StringRef> names;
+  pass_list.split(names, ',', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+  for (auto name : names) {
+    auto kind = PassKind::FromFlagName(name.trim());
+    if (!kind) {
+      return Error(llvm::formatv("Unknown SemIR pass `{0}`", name.trim()));
+    }
+    AddPass(*kind);
+  }
+  return Success();
+}
+
+auto PassManager::EnableTiming() -> void {
+  if (!timer_group_) {
+    timer_group_.emplace("sem-ir", "SemIR pass execution timing report");
+  }
+}
+
+auto PassManager::GetTimer(PassKind kind) -> llvm::Timer* {
+  if (!timer_group_) {
+    return nullptr;
+  }
+  size_t index = kind.AsInt();
+  if (timers_.size() <= index) {
+    timers_.resize(index + 1);
+  }
+  auto& timer = timers_[index];
+  if (!timer) {
+    timer = std::make_unique<llvm::Timer>(kind.flag_name(), kind.flag_name(),
+                                          *timer_group_);
+  }
+  return timer.get();
+}
+
+// Runs a pass over the whole file.
+static auto RunFilePass(FilePassFunction* pass, File& file,
+                        AnalysisManager& analyses) -> void {
+  analyses.Invalidate(pass(file, analyses));
+}
+
+// Runs a pass over each function in the file that has a body.
+static auto RunFunctionPass(FunctionPassFunction* pass, File& file,
+                            AnalysisManager& analyses) -> void {
+  for (int i = 0; i < file.functions_size(); ++i) {
+    FunctionId function_id(i);
+    if (file.GetFunction(function_id).body_block_ids.empty()) {
+      continue;
+    }
+    analyses.Invalidate(function_id, pass(file, analyses, function_id));
+  }
+}
+
+auto PassManager::Run(File& file) -> void {
+  CARBON_CHECK(!file.has_errors()) << "Passes require a valid file";
+
+  AnalysisManager analyses(file);
+  for (auto kind : passes_) {
+    CARBON_VLOG() << "*** SemIR pass " << kind.flag_name() << ": "
+                  << file.filename() << " ***\n";
+    llvm::TimeRegion region(GetTimer(kind));
+    switch (kind) {
+#define CARBON_SEM_IR_PASS_WITH_INFO(Name, FlagName, Scope) \
+  case PassKind::Name:                                       \
+    Run##Scope##Pass(Run##Name, file, analyses);             \
+    break;
+#include "toolchain/sem_ir/pass_kind.def"
+    }
+  }
+
+#ifndef NDEBUG
+  if (auto verify = file.Verify(); !verify.ok()) {
+    CARBON_FATAL() << file << "SemIR passes built invalid semantics IR: "
+                   << verify.error() << "\n";
+  }
+#endif
+}
+
+auto PassManager::PrintTimings(llvm::raw_ostream& out) -> void {
+  if (timer_group_) {
+    timer_group_->print(out, /*ResetAfterPrint=*/true);
+  }
+}
+
+}  // namespace Carbon::SemIR
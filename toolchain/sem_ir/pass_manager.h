@@ -0,0 +1,66 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CARBON_TOOLCHAIN_SEM_IR_PASS_MANAGER_H_
+#define CARBON_TOOLCHAIN_SEM_IR_PASS_MANAGER_H_
+
+#include <memory>
+#include <optional>
+
+#include "common/error.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "toolchain/sem_ir/file.h"
+#include "toolchain/sem_ir/pass_kind.h"
+
+namespace Carbon::SemIR {
+
+// Runs a sequence of SemIR-to-SemIR passes over checked files. The same
+// pipeline may be run over several files, in which case timings are
+// accumulated across all of them.
+class PassManager {
+ public:
+  explicit PassManager(llvm::raw_ostream* vlog_stream = nullptr)
+      : vlog_stream_(vlog_stream) {}
+
+  // Appends the passes in a comma-separated list of pass flag names, such as
+  // `remove-no-ops,merge-blocks`, to the pipeline.
+  auto AddPasses(llvm::StringRef pass_list) -> ErrorOr<Success>;
+
+  // Appends a single pass to the pipeline.
+  auto AddPass(PassKind kind) -> void { passes_.push_back(kind); }
+
+  // Starts recording the time spent in each pass.
+  auto EnableTiming() -> void;
+
+  // Runs the pipeline over the file, which must not have errors.
+  auto Run(File& file) -> void;
+
+  // Prints the time spent in each pass and resets the timers. Does nothing if
+  // timing is not enabled.
+  auto PrintTimings(llvm::raw_ostream& out) -> void;
+
+  // Returns true if there are no passes in the pipeline.
+  auto empty() const -> bool { return passes_.empty(); }
+
+ private:
+  // Returns the timer for a pass, or null if timing is not enabled.
+  auto GetTimer(PassKind kind) -> llvm::Timer*;
+
+  // The optional vlog stream.
+  llvm::raw_ostream* vlog_stream_;
+
+  llvm::SmallVector<PassKind> passes_;
+
+  // Timers are indexed by PassKind, and are created when first used. They must
+  // be destroyed before their group.
+  std::optional<llvm::TimerGroup> timer_group_;
+  llvm::SmallVector<std::unique_ptr<llvm::Timer>> timers_;
+};
+
+}  // namespace Carbon::SemIR
+
+#endif  // CARBON_TOOLCHAIN_SEM_IR_PASS_MANAGER_H_
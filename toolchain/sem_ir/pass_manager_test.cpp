@@ -0,0 +1,138 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/sem_ir/pass_manager.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "llvm/ADT/SmallVector.h"
+#include "toolchain/sem_ir/file.h"
+#include "toolchain/sem_ir/node.h"
+
+namespace Carbon::SemIR {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+TEST(PassManagerTest, AddPasses) {
+  PassManager pass_manager;
+  EXPECT_TRUE(pass_manager.empty());
+  EXPECT_TRUE(pass_manager.AddPasses("").ok());
+  EXPECT_TRUE(pass_manager.empty());
+  EXPECT_TRUE(pass_manager.AddPasses("remove-no-ops, merge-blocks").ok());
+  EXPECT_FALSE(pass_manager.empty());
+
+  auto result = pass_manager.AddPasses("remove-no-ops,no-such-pass");
+  ASSERT_FALSE(result.ok());
+  EXPECT_THAT(result.error().message(), HasSubstr("no-such-pass"));
+}
+
+TEST(PassManagerTest, FlagNames) {
+#define CARBON_SEM_IR_PASS(Name) \
+  EXPECT_EQ(PassKind::FromFlagName(PassKind::Name.flag_name()), PassKind::Name);
+#include "toolchain/sem_ir/pass_kind.def"
+  EXPECT_EQ(PassKind::FromFlagName("Invalid"), std::nullopt);
+}
+
+// Builds function bodies directly in SemIR, for shapes that checking doesn't
+// currently produce, such as `NoOp` nodes and unreachable blocks.
+class PassManagerFileTest : public testing::Test {
+ protected:
+  PassManagerFileTest() : file_("test.carbon", &builtins_) {}
+
+  // Adds a function with no parameters or return type and the given body.
+  auto AddFunction(llvm::ArrayRef<NodeBlockId> body_block_ids) -> FunctionId {
+    return file_.AddFunction(
+        {.name_id = file_.AddString("F"),
+         .param_refs_id = NodeBlockId::Empty,
+         .return_type_id = TypeId::Invalid,
+         .return_slot_id = NodeId::Invalid,
+         .body_block_ids = {body_block_ids.begin(), body_block_ids.end()}});
+  }
+
+  auto AddNode(Node node) -> NodeId { return file_.AddNodeInNoBlock(node); }
+
+  auto RunPasses(llvm::StringRef passes) -> void {
+    PassManager pass_manager;
+    ASSERT_TRUE(pass_manager.AddPasses(passes).ok());
+    pass_manager.Run(file_);
+  }
+
+  auto GetBlock(NodeBlockId block_id) -> llvm::SmallVector<NodeId> {
+    auto block = file_.GetNodeBlock(block_id);
+    return llvm::SmallVector<NodeId>(block.begin(), block.end());
+  }
+
+  File builtins_;
+  File file_;
+};
+
+TEST_F(PassManagerFileTest, RemoveNoOps) {
+  auto no_op = AddNode(Node::NoOp::Make(Parse::Node::Invalid));
+  auto ret = AddNode(Node::Return::Make(Parse::Node::Invalid));
+  auto entry = file_.AddNodeBlock({no_op, ret});
+  auto function_id = AddFunction({entry});
+
+  RunPasses("remove-no-ops");
+  EXPECT_THAT(GetBlock(entry), ElementsAre(ret));
+  EXPECT_THAT(file_.GetFunction(function_id).body_block_ids,
+              ElementsAre(entry));
+}
+
+TEST_F(PassManagerFileTest, RemoveUnreachableBlocks) {
+  auto ret = AddNode(Node::Return::Make(Parse::Node::Invalid));
+  auto dead_ret = AddNode(Node::Return::Make(Parse::Node::Invalid));
+  auto entry = file_.AddNodeBlock({ret});
+  auto dead = file_.AddNodeBlock({dead_ret});
+  auto function_id = AddFunction({entry, dead});
+
+  RunPasses("remove-unreachable-blocks");
+  EXPECT_THAT(file_.GetFunction(function_id).body_block_ids,
+              ElementsAre(entry));
+}
+
+TEST_F(PassManagerFileTest, MergeBlocks) {
+  // entry -> middle -> exit, where each branch is the only one to its target.
+  auto ret = AddNode(Node::Return::Make(Parse::Node::Invalid));
+  auto exit = file_.AddNodeBlock({ret});
+  auto middle_no_op = AddNode(Node::NoOp::Make(Parse::Node::Invalid));
+  auto to_exit = AddNode(Node::Branch::Make(Parse::Node::Invalid, exit));
+  auto middle = file_.AddNodeBlock({middle_no_op, to_exit});
+  auto entry_no_op = AddNode(Node::NoOp::Make(Parse::Node::Invalid));
+  auto to_middle = AddNode(Node::Branch::Make(Parse::Node::Invalid, middle));
+  auto entry = file_.AddNodeBlock({entry_no_op, to_middle});
+  auto function_id = AddFunction({entry, middle, exit});
+
+  RunPasses("merge-blocks");
+  EXPECT_THAT(GetBlock(entry), ElementsAre(entry_no_op, middle_no_op, ret));
+  EXPECT_THAT(file_.GetFunction(function_id).body_block_ids,
+              ElementsAre(entry));
+}
+
+TEST_F(PassManagerFileTest, AllPasses) {
+  auto no_op = AddNode(Node::NoOp::Make(Parse::Node::Invalid));
+  auto ret = AddNode(Node::Return::Make(Parse::Node::Invalid));
+  auto exit = file_.AddNodeBlock({no_op, ret});
+  auto to_exit = AddNode(Node::Branch::Make(Parse::Node::Invalid, exit));
+  auto entry = file_.AddNodeBlock({to_exit});
+  // A block that branches to `exit` but is never reached, so it only prevents
+  // merging until it's removed.
+  auto dead_to_exit = AddNode(Node::Branch::Make(Parse::Node::Invalid, exit));
+  auto dead = file_.AddNodeBlock({dead_to_exit});
+  auto function_id = AddFunction({entry, dead, exit});
+
+  RunPasses("merge-blocks");
+  EXPECT_THAT(file_.GetFunction(function_id).body_block_ids,
+              ElementsAre(entry, dead, exit));
+
+  RunPasses("remove-no-ops,remove-unreachable-blocks,merge-blocks");
+  EXPECT_THAT(GetBlock(entry), ElementsAre(ret));
+  EXPECT_THAT(file_.GetFunction(function_id).body_block_ids,
+              ElementsAre(entry));
+}
+
+}  // namespace
+}  // namespace Carbon::SemIR
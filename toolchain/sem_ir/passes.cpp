@@ -0,0 +1,378 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "toolchain/sem_ir/passes.h"
+
+#include <optional>
+#include <tuple>
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopedHashTable.h"
+#include "llvm/ADT/SmallVector.h"
+#include "toolchain/sem_ir/node_kind.h"
+#include "toolchain/sem_ir/node_operands.h"
+
+namespace Carbon::SemIR {
+
+// Removes nodes for which `remove` returns true from a code block and from the
+// blocks spliced into it.
+static auto RemoveNodesFromCodeBlock(
+    File& file, NodeBlockId block_id,
+    llvm::function_ref<bool(NodeId, Node)> remove) -> void {
+  llvm::SmallVector<NodeId> kept;
+  bool removed_any = false;
+  for (auto node_id : file.GetNodeBlock(block_id)) {
+    auto node = file.GetNode(node_id);
+    if (node.kind() == NodeKind::SpliceBlock) {
+      RemoveNodesFromCodeBlock(file, node.GetAsSpliceBlock().first, remove);
+    }
+    if (remove(node_id, node)) {
+      removed_any = true;
+    } else {
+      kept.push_back(node_id);
+    }
+  }
+  if (removed_any) {
+    file.ReplaceNodeBlock(block_id, kept);
+  }
+}
+
+// Returns whether the node is a name reference of either kind.
+static auto IsNameReference(Node node) -> bool {
+  return node.kind() == NodeKind::NameReference ||
+         node.kind() == NodeKind::NameReferenceUntyped;
+}
+
+auto RunForwardNameReferences(File& file, AnalysisManager& analyses)
+    -> PreservedAnalyses {
+  // Follows a chain of name references to the value that is named.
+  auto resolve = [&](NodeId node_id) {
+    while (node_id.is_valid()) {
+      auto node = file.GetNode(node_id);
+      if (node.kind() == NodeKind::NameReference) {
+        node_id = node.GetAsNameReference().second;
+      } else if (node.kind() == NodeKind::NameReferenceUntyped) {
+        node_id = node.GetAsNameReferenceUntyped().second;
+      } else {
+        break;
+      }
+    }
+    return node_id;
+  };
+
+  bool changed = false;
+  for (int i = 0; i < file.nodes_size(); ++i) {
+    NodeId node_id(i);
+    auto node = file.GetNode(node_id);
+    bool node_changed = false;
+    auto new_node = MapNodeOperands(node, [&](NodeId operand_id) {
+      auto target_id = resolve(operand_id);
+      node_changed |= target_id != operand_id;
+      return target_id;
+    });
+    if (node_changed) {
+      file.ReplaceNode(node_id, new_node);
+      changed = true;
+    }
+    if (auto block_id = GetOperandBlock(node); block_id.is_valid()) {
+      for (auto& operand_id : file.GetNodeBlock(block_id)) {
+        auto target_id = resolve(operand_id);
+        changed |= target_id != operand_id;
+        operand_id = target_id;
+      }
+    }
+  }
+  if (!changed) {
+    return PreservedAnalyses::All();
+  }
+
+  // Name references that are no longer used don't need to be evaluated.
+  analyses.Invalidate({.control_flow_graph = true});
+  const auto& uses = analyses.GetNodeUses();
+  for (int i = 0; i < file.functions_size(); ++i) {
+    for (auto block_id : file.GetFunction(FunctionId(i)).body_block_ids) {
+      RemoveNodesFromCodeBlock(file, block_id, [&](NodeId node_id, Node node) {
+        return IsNameReference(node) && uses.count(node_id) == 0;
+      });
+    }
+  }
+  // Removing a node from a code block doesn't change any references.
+  return {.node_uses = true, .control_flow_graph = true};
+}
+
+// The identity of the value computed by a node for value numbering: the node
+// kind, type, two operands, and the memory state observed by the node.
+using ValueKey = std::tuple<int32_t, int32_t, int32_t, int32_t, int32_t>;
+
+namespace {
+// Assigns value numbers to the nodes in function bodies, and finds nodes that
+// are redundant with a node that dominates them.
+class ValueNumbering {
+ public:
+  explicit ValueNumbering(const File& file) : file_(&file) {}
+
+  // Finds redundant nodes in the blocks of a function, visiting the blocks in
+  // dominator tree order so that only dominating nodes are reused.
+  auto NumberFunction(const DominatorTree& tree) -> void {
+    NumberBlockAndChildren(tree, tree.root());
+  }
+
+  // Returns the node that should be used in place of the given node.
+  auto GetReplacement(NodeId node_id) const -> NodeId {
+    auto it = replacements_.find(node_id);
+    return it == replacements_.end() ? node_id : it->second;
+  }
+
+  auto replacements() const -> const llvm::DenseMap<NodeId, NodeId>& {
+    return replacements_;
+  }
+
+ private:
+  auto NumberBlockAndChildren(const DominatorTree& tree, NodeBlockId block_id)
+      -> void {
+    llvm::ScopedHashTableScope<ValueKey, NodeId> scope(values_);
+    // Control may reach this block along a path that writes to memory, so
+    // start a new memory state.
+    memory_version_ = ++last_memory_version_;
+    NumberCodeBlock(block_id);
+    for (auto child_id : tree.children(block_id)) {
+      NumberBlockAndChildren(tree, child_id);
+    }
+  }
+
+  auto NumberCodeBlock(NodeBlockId block_id) -> void {
+    for (auto node_id : file_->GetNodeBlock(block_id)) {
+      auto node = MapNodeOperands(file_->GetNode(node_id), [&](NodeId id) {
+        return GetReplacement(id);
+      });
+      if (node.kind() == NodeKind::SpliceBlock) {
+        NumberCodeBlock(node.GetAsSpliceBlock().first);
+      }
+      if (MayWriteMemory(node)) {
+        memory_version_ = ++last_memory_version_;
+      }
+      auto key = GetValueKey(node);
+      if (!key) {
+        continue;
+      }
+      if (auto it = values_.begin(*key); it != values_.end()) {
+        replacements_.insert({node_id, *it});
+      } else {
+        values_.insert(*key, node_id);
+      }
+    }
+  }
+
+  // Returns whether evaluating the node may change the contents of memory.
+  static auto MayWriteMemory(Node node) -> bool {
+    switch (node.kind()) {
+      case NodeKind::ArrayInit:
+      case NodeKind::Assign:
+      case NodeKind::Call:
+      case NodeKind::InitializeFrom:
+      case NodeKind::StructInit:
+      case NodeKind::Temporary:
+      case NodeKind::TupleInit:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Returns the value key for the node, or nullopt if the node may not be
+  // replaced by another node with the same kind and operands.
+  auto GetValueKey(Node node) -> std::optional<ValueKey> {
+    auto make_key = [&](int32_t arg0, int32_t arg1,
+                        int32_t memory_version = 0) -> ValueKey {
+      return {static_cast<int32_t>(NodeKind::RawEnumType(node.kind())),
+              node.type_id().index, arg0, arg1, memory_version};
+    };
+    switch (node.kind()) {
+      case NodeKind::AddressOf:
+        return make_key(node.GetAsAddressOf().index, 0);
+      case NodeKind::ArrayIndex: {
+        auto [array_id, index_id] = node.GetAsArrayIndex();
+        return make_key(array_id.index, index_id.index);
+      }
+      case NodeKind::BindValue:
+        // Loads the value from memory.
+        return make_key(node.GetAsBindValue().index, 0, memory_version_);
+      case NodeKind::BoolLiteral:
+        return make_key(node.GetAsBoolLiteral().index, 0);
+      case NodeKind::Dereference:
+        return make_key(node.GetAsDereference().index, 0);
+      case NodeKind::IntegerLiteral: {
+        // Equal literals are stored separately, so number them by value.
+        auto integer_id = node.GetAsIntegerLiteral();
+        auto it = integer_values_
+                      .insert({file_->GetIntegerLiteral(integer_id), integer_id})
+                      .first;
+        return make_key(it->second.index, 0);
+      }
+      case NodeKind::NameReference: {
+        auto [name_id, value_id] = node.GetAsNameReference();
+        return make_key(name_id.index, value_id.index);
+      }
+      case NodeKind::StringLiteral:
+        return make_key(node.GetAsStringLiteral().index, 0);
+      case NodeKind::StructAccess: {
+        auto [struct_id, index] = node.GetAsStructAccess();
+        return make_key(struct_id.index, index.index);
+      }
+      case NodeKind::TupleAccess: {
+        auto [tuple_id, index] = node.GetAsTupleAccess();
+        return make_key(tuple_id.index, index.index);
+      }
+      case NodeKind::TupleIndex: {
+        auto [tuple_id, index_id] = node.GetAsTupleIndex();
+        return make_key(tuple_id.index, index_id.index);
+      }
+      case NodeKind::UnaryOperatorNot:
+        return make_key(node.GetAsUnaryOperatorNot().index, 0);
+      case NodeKind::ValueAsReference:
+        return make_key(node.GetAsValueAsReference().index, 0);
+      default:
+        // Other nodes either have side effects, create distinct storage, or
+        // aren't expected to be repeated in function bodies.
+        return std::nullopt;
+    }
+  }
+
+  const File* file_;
+
+  llvm::ScopedHashTable<ValueKey, NodeId> values_;
+  llvm::DenseMap<NodeId, NodeId> replacements_;
+
+  // Maps each integer value to the first literal ID seen with that value.
+  llvm::DenseMap<llvm::APInt, IntegerLiteralId> integer_values_;
+
+  int32_t memory_version_ = 0;
+  int32_t last_memory_version_ = 0;
+};
+}  // namespace
+
+auto RunValueNumbering(File& file, AnalysisManager& analyses)
+    -> PreservedAnalyses {
+  ValueNumbering numbering(file);
+  for (int i = 0; i < file.functions_size(); ++i) {
+    FunctionId function_id(i);
+    if (!file.GetFunction(function_id).body_block_ids.empty()) {
+      numbering.NumberFunction(analyses.GetDominatorTree(function_id));
+    }
+  }
+  if (numbering.replacements().empty()) {
+    return PreservedAnalyses::All();
+  }
+
+  // Rewrite all uses of redundant nodes, then remove them.
+  auto replace = [&](NodeId node_id) {
+    return numbering.GetReplacement(node_id);
+  };
+  for (int i = 0; i < file.nodes_size(); ++i) {
+    NodeId node_id(i);
+    auto node = file.GetNode(node_id);
+    file.ReplaceNode(node_id, MapNodeOperands(node, replace));
+    if (auto block_id = GetOperandBlock(node); block_id.is_valid()) {
+      for (auto& operand_id : file.GetNodeBlock(block_id)) {
+        operand_id = replace(operand_id);
+      }
+    }
+  }
+  for (int i = 0; i < file.functions_size(); ++i) {
+    for (auto block_id : file.GetFunction(FunctionId(i)).body_block_ids) {
+      RemoveNodesFromCodeBlock(
+          file, block_id, [&](NodeId node_id, Node /*node*/) {
+            return numbering.replacements().count(node_id) > 0;
+          });
+    }
+  }
+  return {.control_flow_graph = true};
+}
+
+auto RunRemoveNoOps(File& file, AnalysisManager& analyses,
+                    FunctionId function_id) -> PreservedAnalyses {
+  const auto& uses = analyses.GetNodeUses();
+  for (auto block_id : file.GetFunction(function_id).body_block_ids) {
+    RemoveNodesFromCodeBlock(file, block_id, [&](NodeId node_id, Node node) {
+      return node.kind() == NodeKind::NoOp && uses.count(node_id) == 0;
+    });
+  }
+  // Neither references nor terminators are changed.
+  return PreservedAnalyses::All();
+}
+
+auto RunRemoveUnreachableBlocks(File& file, AnalysisManager& analyses,
+                                FunctionId function_id) -> PreservedAnalyses {
+  const auto& cfg = analyses.GetControlFlowGraph(function_id);
+  auto& body_block_ids = file.GetFunction(function_id).body_block_ids;
+  auto old_size = body_block_ids.size();
+  llvm::erase_if(body_block_ids, [&](NodeBlockId block_id) {
+    return !cfg.is_reachable(block_id);
+  });
+  if (body_block_ids.size() == old_size) {
+    return PreservedAnalyses::All();
+  }
+  // References from the removed blocks are gone, as are their branches.
+  return PreservedAnalyses::None();
+}
+
+auto RunMergeBlocks(File& file, AnalysisManager& analyses,
+                    FunctionId function_id) -> PreservedAnalyses {
+  const auto& cfg = analyses.GetControlFlowGraph(function_id);
+  auto& body_block_ids = file.GetFunction(function_id).body_block_ids;
+  if (body_block_ids.empty()) {
+    return PreservedAnalyses::All();
+  }
+  // Only merge forward, so that values are still lowered in lexical order
+  // before their uses.
+  llvm::DenseMap<NodeBlockId, int> lexical_order;
+  for (auto [i, block_id] : llvm::enumerate(body_block_ids)) {
+    lexical_order[block_id] = i;
+  }
+
+  // Merging a block into its only predecessor doesn't change the number of
+  // predecessors of any other block, so `cfg` remains accurate enough to find
+  // chains of blocks to merge.
+  llvm::DenseSet<NodeBlockId> merged;
+  for (auto block_id : body_block_ids) {
+    if (merged.contains(block_id)) {
+      continue;
+    }
+    while (true) {
+      auto block = file.GetNodeBlock(block_id);
+      if (block.empty()) {
+        break;
+      }
+      // The branch must be the whole terminator sequence.
+      auto terminator = file.GetNode(block.back());
+      if (terminator.kind() != NodeKind::Branch ||
+          (block.size() > 1 &&
+           file.GetNode(block[block.size() - 2]).kind().terminator_kind() !=
+               TerminatorKind::NotTerminator)) {
+        break;
+      }
+      auto target_id = terminator.GetAsBranch();
+      if (lexical_order.lookup(target_id) <= lexical_order.lookup(block_id) ||
+          cfg.predecessors(target_id).size() != 1) {
+        break;
+      }
+      llvm::SmallVector<NodeId> content(block.begin(), block.end() - 1);
+      auto target = file.GetNodeBlock(target_id);
+      content.append(target.begin(), target.end());
+      file.ReplaceNodeBlock(block_id, content);
+      merged.insert(target_id);
+    }
+  }
+  if (merged.empty()) {
+    return PreservedAnalyses::All();
+  }
+  llvm::erase_if(body_block_ids, [&](NodeBlockId block_id) {
+    return merged.contains(block_id);
+  });
+  return {.node_uses = true};
+}
+
+}  // namespace Carbon::SemIR
@@ -0,0 +1,29 @@
+// Part of the Carbon Language project, under the Apache License v2.0 with LLVM
+// Exceptions. See /LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef CARBON_TOOLCHAIN_SEM_IR_PASSES_H_
+#define CARBON_TOOLCHAIN_SEM_IR_PASSES_H_
+
+#include "toolchain/sem_ir/analysis.h"
+#include "toolchain/sem_ir/file.h"
+
+namespace Carbon::SemIR {
+
+// A pass over a whole file. Returns the analyses that are still valid.
+using FilePassFunction = auto(File& file, AnalysisManager& analyses)
+    -> PreservedAnalyses;
+
+// A pass over a single function with a body. Returns the analyses that are
+// still valid.
+using FunctionPassFunction = auto(File& file, AnalysisManager& analyses,
+                                  FunctionId function_id) -> PreservedAnalyses;
+
+// Declare the implementation of each pass in pass_kind.def.
+#define CARBON_SEM_IR_PASS_WITH_INFO(Name, FlagName, Scope) \
+  Scope##PassFunction Run##Name;
+#include "toolchain/sem_ir/pass_kind.def"
+
+}  // namespace Carbon::SemIR
+
+#endif  // CARBON_TOOLCHAIN_SEM_IR_PASSES_H_
@@ -37,7 +37,10 @@ class ToolchainFileTest : public FileTestBase {
     } else if (component_ == "lex") {
       return {"compile", "--phase=lex", "--dump-tokens", "%s"};
     } else if (component_ == "lower") {
-      return {"compile", "--phase=lower", "--dump-llvm-ir", "%s"};
+      // The module records the target and its data layout, so use a fixed
+      // target rather than the host.
+      return {"compile", "--phase=lower", "--dump-llvm-ir",
+              "--target=x86_64-unknown-linux-gnu", "%s"};
     } else if (component_ == "parse") {
       return {"compile", "--phase=parse", "--dump-parse-tree", "%s"};
     } else if (component_ == "codegen" || component_ == "driver") {